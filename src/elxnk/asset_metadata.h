@@ -0,0 +1,125 @@
+// Asset Metadata - compile-time geometry of the embedded library
+//
+// svgc computes the geometry of every embedded asset at build time and
+// writes it as constexpr tables (build/gen/asset_metadata_table.h, included
+// below; compile with -I build/gen). Everything here is constexpr, so
+// geometry known at compile time costs nothing at runtime:
+//
+//   constexpr const ComponentInfo* r = component_info("R");
+//   static_assert(r->pin_count == 2, "resistor has two leads");
+//
+// and runtime queries are a binary search over names or a direct index,
+// with no stroke data decoded.
+//
+// All coordinates are library pixels of the full-detail, unrotated asset
+// (ORIENT_R0). oriented_point() and oriented_bounds() map them into any
+// precomputed orientation the same way svgc builds the variants, so the top
+// left corner of the bounding box stays in place.
+//
+// PINS: taken from marker elements in the SVG (id or class starting with
+// "pin", not drawn) when there are any; otherwise detected as the open ends
+// of leads on the bounding box. Mark pins in the SVG where detection guesses
+// wrong.
+//
+// Library files loaded at runtime (library_file.h) carry no metadata; these
+// tables only describe the embedded library.
+
+#ifndef ELXNK_ASSET_METADATA_H
+#define ELXNK_ASSET_METADATA_H
+
+#include "component_library.h"
+
+namespace elxnk {
+
+struct AssetPoint {
+    int x, y;
+};
+
+// Inclusive bounding box of everything drawn, circles included
+struct AssetBounds {
+    int x0, y0, x1, y1;
+
+    constexpr int width() const { return x1 - x0; }
+    constexpr int height() const { return y1 - y0; }
+    constexpr bool contains(int x, int y) const { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+};
+
+struct ComponentInfo {
+    const char* name;
+    AssetBounds bounds;
+    int strokes;                // Pen strokes, circles excluded
+    int circles;
+    bool pins_marked;           // Pins come from SVG markers, not detection
+    int pin_count;
+    const AssetPoint* pins;     // pin_count anchors, NULL if none
+};
+
+struct GlyphInfo {
+    char character;
+    AssetBounds bounds;
+    int strokes;
+    int circles;
+    int advance;                // Width plus the left bearing again on the right
+};
+
+}  // namespace elxnk
+
+#include "asset_metadata_table.h"
+
+namespace elxnk {
+
+// strcmp() for constant expressions
+constexpr int metadata_compare(const char* a, const char* b) {
+    return *a != *b ? ((unsigned char)*a < (unsigned char)*b ? -1 : 1)
+         : *a == '\0' ? 0
+         : metadata_compare(a + 1, b + 1);
+}
+
+constexpr const ComponentInfo* component_info_search(const char* name, int lo, int hi) {
+    return lo > hi ? nullptr
+         : metadata_compare(name, COMPONENT_INFO[(lo + hi) / 2].name) == 0 ? &COMPONENT_INFO[(lo + hi) / 2]
+         : metadata_compare(name, COMPONENT_INFO[(lo + hi) / 2].name) < 0
+             ? component_info_search(name, lo, (lo + hi) / 2 - 1)
+             : component_info_search(name, (lo + hi) / 2 + 1, hi);
+}
+
+// Component geometry by name, nullptr if not in the embedded library
+constexpr const ComponentInfo* component_info(const char* name) {
+    return component_info_search(name, 0, COMPONENT_INFO_COUNT - 1);
+}
+
+constexpr const GlyphInfo* glyph_info_search(unsigned char c, int lo, int hi) {
+    return lo > hi ? nullptr
+         : (unsigned char)GLYPH_INFO[(lo + hi) / 2].character == c ? &GLYPH_INFO[(lo + hi) / 2]
+         : c < (unsigned char)GLYPH_INFO[(lo + hi) / 2].character
+             ? glyph_info_search(c, lo, (lo + hi) / 2 - 1)
+             : glyph_info_search(c, (lo + hi) / 2 + 1, hi);
+}
+
+// Glyph geometry by character, nullptr if there is no glyph
+constexpr const GlyphInfo* glyph_info(char c) {
+    return glyph_info_search((unsigned char)c, 0, GLYPH_INFO_COUNT - 1);
+}
+
+// Offset (dx, dy) from the top left corner, turned clockwise within b
+constexpr AssetPoint turn_point(const AssetBounds& b, int dx, int dy, int quarter_turns) {
+    return quarter_turns == 0 ? AssetPoint{b.x0 + dx, b.y0 + dy}
+         : quarter_turns == 1 ? AssetPoint{b.x0 + b.height() - dy, b.y0 + dx}
+         : quarter_turns == 2 ? AssetPoint{b.x0 + b.width() - dx, b.y0 + b.height() - dy}
+         : AssetPoint{b.x0 + dy, b.y0 + b.width() - dx};
+}
+
+// Where point p of an asset with bounds b ends up in an orientation variant
+constexpr AssetPoint oriented_point(const AssetBounds& b, const AssetPoint& p, int orientation) {
+    return turn_point(b, (orientation >= ORIENT_MX ? b.x1 - p.x : p.x - b.x0), p.y - b.y0,
+                      orientation % 4);
+}
+
+// Bounds of an orientation variant: same corner, sides swapped by odd turns
+constexpr AssetBounds oriented_bounds(const AssetBounds& b, int orientation) {
+    return orientation % 2 ? AssetBounds{b.x0, b.y0, b.x0 + b.height(), b.y0 + b.width()} : b;
+}
+
+}  // namespace elxnk
+
+#endif  // ELXNK_ASSET_METADATA_H
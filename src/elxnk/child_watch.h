@@ -0,0 +1,154 @@
+// Child Watch - event-driven exit notification for elxnk's children
+//
+// Each child started gets a pidfd (pidfd_open, Linux 5.3+), which becomes
+// readable when the child exits and goes in the caller's epoll set. Where
+// pidfds are not available, SIGCHLD is blocked and read from a signalfd
+// instead, which wakes the loop on any child's exit. Either way reap()
+// collects exits with waitpid(), so the status is known and no zombies are
+// left, and only the children added here are waited for, so a system()
+// elsewhere still gets its own child's status.
+//
+// Nothing polls: a controller whose children are running sleeps in
+// epoll_wait() until one exits.
+
+#ifndef ELXNK_CHILD_WATCH_H
+#define ELXNK_CHILD_WATCH_H
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <vector>
+
+#ifndef __NR_pidfd_open
+#define __NR_pidfd_open 434     // The same on every architecture
+#endif
+
+namespace elxnk {
+
+struct ChildExit {
+    pid_t pid;
+    int status;                 // As from waitpid(), -1 if reaped elsewhere
+};
+
+class ChildWatch {
+private:
+    struct Watched {
+        pid_t pid;
+        int pidfd;              // -1 with the signalfd
+    };
+
+    std::vector<Watched> watched;
+    int epoll_fd;
+    int signal_fd;              // SIGCHLD, when pidfds are not available
+    bool pidfds;
+
+    static int pidfd_open(pid_t pid) {
+        return (int)syscall(__NR_pidfd_open, pid, 0);
+    }
+
+    void watch_fd(int fd) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void unwatch(size_t i) {
+        if (watched[i].pidfd >= 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, watched[i].pidfd, NULL);
+            close(watched[i].pidfd);
+        }
+        watched.erase(watched.begin() + i);
+    }
+
+public:
+    ChildWatch() : epoll_fd(-1), signal_fd(-1), pidfds(false) {}
+
+    ~ChildWatch() {
+        while (!watched.empty()) unwatch(watched.size() - 1);
+        if (signal_fd >= 0) close(signal_fd);
+    }
+
+    // Report exits through epfd; false if neither pidfds nor a signalfd
+    // can be had
+    bool open(int epfd) {
+        epoll_fd = epfd;
+        int probe = pidfd_open(getpid());
+        if (probe >= 0) {
+            close(probe);
+            pidfds = true;
+            return true;
+        }
+
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        if (sigprocmask(SIG_BLOCK, &mask, NULL) < 0) return false;
+        signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (signal_fd < 0) return false;
+        watch_fd(signal_fd);
+        return true;
+    }
+
+    bool using_pidfds() const {
+        return pidfds;
+    }
+
+    // A child just forked. With pidfds, one that cannot be had leaves the
+    // child unwatched and returns false.
+    bool add(pid_t pid) {
+        Watched w = { pid, -1 };
+        if (pidfds) {
+            w.pidfd = pidfd_open(pid);
+            if (w.pidfd < 0) return false;
+            watch_fd(w.pidfd);
+        }
+        watched.push_back(w);
+        return true;
+    }
+
+    // Stop watching a child, to wait for it some other way
+    void forget(pid_t pid) {
+        for (size_t i = 0; i < watched.size(); i++) {
+            if (watched[i].pid == pid) {
+                unwatch(i);
+                return;
+            }
+        }
+    }
+
+    // Whether an epoll event's descriptor is one of ours
+    bool owns(int fd) const {
+        if (fd == signal_fd) return true;
+        for (size_t i = 0; i < watched.size(); i++) {
+            if (watched[i].pidfd == fd) return true;
+        }
+        return false;
+    }
+
+    // One of ours was readable: the children that exited, reaped
+    void reap(int fd, std::vector<ChildExit>& exited) {
+        if (fd == signal_fd) {
+            struct signalfd_siginfo info;
+            while (read(signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {}
+        }
+        for (size_t i = watched.size(); i-- > 0;) {
+            int status;
+            pid_t r = waitpid(watched[i].pid, &status, WNOHANG);
+            if (r == watched[i].pid || (r < 0 && errno == ECHILD)) {
+                ChildExit e = { watched[i].pid, r == watched[i].pid ? status : -1 };
+                exited.push_back(e);
+                unwatch(i);
+            }
+        }
+    }
+};
+
+}  // namespace elxnk
+
+#endif  // ELXNK_CHILD_WATCH_H
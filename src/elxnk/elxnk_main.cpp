@@ -1,12 +1,21 @@
 // Elxnk Main Controller
 // Integrates lampv2 (drawing engine) and geniev2 (gesture detector)
 // Provides unified process management and UI control
+//
+// The main loop sleeps in epoll_wait() until a child exits (child_watch.h)
+// or a signal arrives through a signalfd; it only times out while a
+// restart is pending. When a child is restarted, and whether it is given up
+// on, is its restart policy's call (restart_policy.h), with the limits from
+// the [Process] section of the config file (argv[1], default ELXNK_CONFIG).
+// SIGUSR1 logs the restart counters, which are also logged at shutdown.
 
 #include <unistd.h>
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,6 +25,9 @@
 #include <stdarg.h>
 #include <string>
 #include <vector>
+#include "child_watch.h"
+#include "lamp_pen.h"
+#include "restart_policy.h"
 
 // Configuration
 #define LAMP_BINARY "/opt/bin/lamp"
@@ -25,6 +37,7 @@
 #define UI_INIT_SCRIPT "/opt/bin/ui_state.sh"
 #define LOG_FILE "/tmp/elxnk.log"
 #define PID_FILE "/tmp/elxnk.pid"
+#define ELXNK_CONFIG "/opt/etc/elxnk.conf"
 
 // Global state
 static pid_t lamp_pid = -1;
@@ -32,6 +45,16 @@ static pid_t genie_pid = -1;
 static FILE* log_fp = NULL;
 static int lamp_pipe_fd = -1;
 static bool running = true;
+static int epoll_fd = -1;
+static int signal_fd = -1;              // Shutdown signals
+static elxnk::ChildWatch children;
+static elxnk::RestartLimits limits;
+
+static long long now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
 
 // Logging
 void log_msg(const char* level, const char* format, ...) {
@@ -53,26 +76,45 @@ void log_msg(const char* level, const char* format, ...) {
     fflush(log_fp);
 }
 
-// Signal handler for graceful shutdown
-void signal_handler(int signo) {
-    log_msg("INFO", "Received signal %d, initiating shutdown", signo);
-    running = false;
-}
+// Shutdown signals and child exits, both delivered to the epoll loop.
+// Children are reaped by ChildWatch, so SIGCHLD keeps its default action.
+bool setup_signals() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        log_msg("ERROR", "Failed to create epoll instance: %s", strerror(errno));
+        return false;
+    }
 
-// Setup signal handlers
-void setup_signals() {
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = signal_handler;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGHUP);
+    sigaddset(&mask, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0) {
+        log_msg("ERROR", "Failed to create signalfd: %s", strerror(errno));
+        return false;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = signal_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, signal_fd, &ev);
 
-    sigaction(SIGINT, &sa, NULL);
-    sigaction(SIGTERM, &sa, NULL);
-    sigaction(SIGHUP, &sa, NULL);
+    if (!children.open(epoll_fd)) {
+        log_msg("ERROR", "Cannot watch child processes: %s", strerror(errno));
+        return false;
+    }
+    log_msg("INFO", "Watching children with %s", children.using_pidfds() ? "pidfds" : "SIGCHLD signalfd");
+    return true;
+}
 
-    // Ignore SIGCHLD to prevent zombie processes
-    signal(SIGCHLD, SIG_IGN);
+// In a forked child: the signals blocked for the loop go back to normal
+void reset_child_signals() {
+    sigset_t none;
+    sigemptyset(&none);
+    sigprocmask(SIG_SETMASK, &none, NULL);
 }
 
 // Create named pipe for lamp
@@ -90,6 +132,17 @@ bool create_lamp_pipe() {
     return true;
 }
 
+// Directory lamp publishes its drawing window in (lamp_pen.h); the service
+// owns it, lamp writes the file and genie_lamp only reads it
+bool create_run_dir() {
+    if (mkdir(LAMP_PEN_DIR, 0755) < 0 && errno != EEXIST) {
+        log_msg("ERROR", "Failed to create %s: %s", LAMP_PEN_DIR, strerror(errno));
+        return false;
+    }
+    chmod(LAMP_PEN_DIR, 0755);
+    return true;
+}
+
 // Start lamp process
 bool start_lamp() {
     log_msg("INFO", "Starting lamp process...");
@@ -101,6 +154,8 @@ bool start_lamp() {
     }
 
     if (lamp_pid == 0) {
+        reset_child_signals();
+
         // Child process - redirect stdin from pipe
         int fd = open(LAMP_PIPE, O_RDONLY);
         if (fd < 0) {
@@ -132,6 +187,7 @@ bool start_lamp() {
     if (lamp_pipe_fd < 0) {
         log_msg("ERROR", "Failed to open lamp pipe for writing: %s", strerror(errno));
         kill(lamp_pid, SIGTERM);
+        waitpid(lamp_pid, NULL, 0);
         lamp_pid = -1;
         return false;
     }
@@ -151,6 +207,8 @@ bool start_genie() {
     }
 
     if (genie_pid == 0) {
+        reset_child_signals();
+
         // Child process - redirect output to log
         int log_fd = open(LOG_FILE, O_WRONLY | O_APPEND | O_CREAT, 0644);
         if (log_fd >= 0) {
@@ -206,73 +264,224 @@ bool is_process_alive(pid_t pid) {
     return kill(pid, 0) == 0;
 }
 
-// Monitor child processes and restart if needed
-void monitor_processes() {
-    // Check lamp
-    if (!is_process_alive(lamp_pid)) {
-        log_msg("WARN", "Lamp process died, restarting...");
-        if (lamp_pipe_fd >= 0) {
-            close(lamp_pipe_fd);
-            lamp_pipe_fd = -1;
+// Read the [Process] section of the config file; defaults for the rest
+void load_config(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        log_msg("INFO", "No config at %s, using default restart limits", path);
+        return;
+    }
+
+    char line[256];
+    bool process = false;
+    while (fgets(line, sizeof(line), fp)) {
+        std::string text(line);
+        size_t start = text.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos || text[start] == '#') continue;
+        size_t end = text.find_last_not_of(" \t\r\n");
+        text = text.substr(start, end - start + 1);
+
+        if (text[0] == '[') {
+            process = text == "[Process]";
+            continue;
+        }
+        size_t eq = text.find('=');
+        if (!process || eq == std::string::npos) continue;
+        if (!limits.set(text.substr(0, eq), text.substr(eq + 1))) {
+            log_msg("WARN", "Unknown [Process] setting '%s' in %s", text.substr(0, eq).c_str(), path);
         }
-        sleep(1);
-        start_lamp();
     }
+    fclose(fp);
 
-    // Check genie_lamp
-    if (!is_process_alive(genie_pid)) {
-        log_msg("WARN", "Genie_lamp process died, restarting...");
-        sleep(1);
-        start_genie();
+    log_msg("INFO", "Restart policy: backoff %lld-%lld ms +/-%d%%, stable after %lld ms, %d restarts per %lld ms, "
+            "degraded retry %lld ms", limits.delay_ms, limits.max_delay_ms, limits.jitter_pct, limits.stable_ms,
+            limits.budget, limits.window_ms, limits.degraded_retry_ms);
+}
+
+// A child kept running
+struct Supervised {
+    const char* name;
+    pid_t* pid;
+    bool (*start)();
+    long long started_ms;
+    long long restart_ms;       // When to start it again, -1 if not due
+    elxnk::RestartPolicy policy;
+};
+
+static Supervised lamp_child = { "lamp", &lamp_pid, start_lamp, 0, -1, elxnk::RestartPolicy() };
+static Supervised genie_child = { "genie_lamp", &genie_pid, start_genie, 0, -1, elxnk::RestartPolicy() };
+static Supervised* supervised[] = { &lamp_child, &genie_child };
+
+// The child is down, for the reason given: restart it when its policy says
+void schedule_restart(Supervised& c, pid_t pid, const char* how) {
+    long long now = now_ms();
+    long long delay = c.policy.exited(limits, now, now - c.started_ms);
+    c.restart_ms = delay < 0 ? -1 : now + delay;
+
+    char who[64];
+    if (pid > 0) {
+        snprintf(who, sizeof(who), "%s (PID %d)", c.name, pid);
+    } else {
+        snprintf(who, sizeof(who), "%s", c.name);
+    }
+    if (c.policy.degraded && delay < 0) {
+        log_msg("ERROR", "%s %s, over its budget of %d restarts in %lld ms; degraded, not restarting", who, how,
+                limits.budget, limits.window_ms);
+    } else if (c.policy.degraded) {
+        log_msg("ERROR", "%s %s, over its budget of %d restarts in %lld ms; degraded, retrying in %lld ms", who, how,
+                limits.budget, limits.window_ms, delay);
+    } else if (delay == 0) {
+        log_msg("WARN", "%s %s, restarting...", who, how);
+    } else {
+        log_msg("WARN", "%s %s, %d in a row, restarting in %lld ms", who, how, c.policy.streak, delay);
     }
 }
 
-// Cleanup and shutdown
-void cleanup() {
-    log_msg("INFO", "Cleaning up...");
+bool start_child(Supervised& c) {
+    c.started_ms = now_ms();
+    c.restart_ms = -1;
+    if (!c.start()) {
+        schedule_restart(c, -1, "failed to start");
+        return false;
+    }
+    c.policy.started();
+    if (!children.add(*c.pid)) {
+        log_msg("WARN", "Cannot watch %s (PID %d): %s", c.name, *c.pid, strerror(errno));
+    }
+    return true;
+}
 
-    // Stop genie_lamp first (no more gestures)
-    if (genie_pid > 0) {
-        log_msg("INFO", "Stopping genie_lamp (PID %d)", genie_pid);
-        kill(genie_pid, SIGTERM);
-
-        // Wait up to 3 seconds
-        for (int i = 0; i < 30; i++) {
-            if (!is_process_alive(genie_pid)) break;
-            usleep(100000);
-        }
+void log_restart_stats() {
+    long long now = now_ms();
+    for (size_t i = 0; i < sizeof(supervised) / sizeof(supervised[0]); i++) {
+        const Supervised& c = *supervised[i];
+        const elxnk::RestartPolicy& p = c.policy;
+        const char* state = *c.pid > 0 ? "running" : p.degraded ? "degraded" : c.restart_ms >= 0 ? "backing off"
+                                                                                                  : "stopped";
+        log_msg("INFO", "%s: %s, %lu starts, %lu exits (%d in a row), %lu restarts (%d in window), "
+                "%lu times degraded, last delay %lld ms", c.name, state, p.starts, p.exits, p.streak, p.restarts,
+                p.in_window(limits, now), p.degradations, p.last_delay_ms);
+    }
+}
 
-        if (is_process_alive(genie_pid)) {
-            log_msg("WARN", "Force killing genie_lamp");
-            kill(genie_pid, SIGKILL);
-        }
-        genie_pid = -1;
+void describe_exit(int status, char* buf, size_t size) {
+    if (status < 0) {
+        snprintf(buf, size, "exited");
+    } else if (WIFSIGNALED(status)) {
+        snprintf(buf, size, "was killed by signal %d (%s)", WTERMSIG(status), strsignal(WTERMSIG(status)));
+    } else {
+        snprintf(buf, size, "exited with status %d", WEXITSTATUS(status));
     }
+}
 
-    // Stop lamp
-    if (lamp_pid > 0) {
-        log_msg("INFO", "Stopping lamp (PID %d)", lamp_pid);
+// A child exited: schedule its restart
+void child_exited(const elxnk::ChildExit& e) {
+    for (size_t i = 0; i < sizeof(supervised) / sizeof(supervised[0]); i++) {
+        Supervised& c = *supervised[i];
+        if (*c.pid != e.pid) continue;
 
-        // Close pipe first
-        if (lamp_pipe_fd >= 0) {
+        char how[96];
+        describe_exit(e.status, how, sizeof(how));
+        *c.pid = -1;
+        if (&c == &lamp_child && lamp_pipe_fd >= 0) {
             close(lamp_pipe_fd);
             lamp_pipe_fd = -1;
         }
+        schedule_restart(c, e.pid, how);
+        return;
+    }
+}
 
-        kill(lamp_pid, SIGTERM);
+// Milliseconds until the next restart is due, -1 if none
+int restart_timeout_ms() {
+    long long now = now_ms(), wait = -1;
+    for (size_t i = 0; i < sizeof(supervised) / sizeof(supervised[0]); i++) {
+        const Supervised& c = *supervised[i];
+        if (c.restart_ms < 0) continue;
+        long long left = c.restart_ms > now ? c.restart_ms - now : 0;
+        if (wait < 0 || left < wait) wait = left;
+    }
+    return (int)wait;
+}
 
-        // Wait up to 3 seconds
-        for (int i = 0; i < 30; i++) {
-            if (!is_process_alive(lamp_pid)) break;
-            usleep(100000);
+void restart_due() {
+    long long now = now_ms();
+    for (size_t i = 0; i < sizeof(supervised) / sizeof(supervised[0]); i++) {
+        Supervised& c = *supervised[i];
+        if (c.restart_ms >= 0 && now >= c.restart_ms) start_child(c);
+    }
+}
+
+// Wait in epoll until a child exits or a shutdown signal arrives
+void supervise() {
+    std::vector<elxnk::ChildExit> exited;
+    while (running) {
+        struct epoll_event events[8];
+        int n = epoll_wait(epoll_fd, events, 8, restart_timeout_ms());
+        if (n < 0 && errno != EINTR) {
+            log_msg("ERROR", "epoll_wait failed: %s", strerror(errno));
+            break;
         }
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == signal_fd) {
+                struct signalfd_siginfo info;
+                while (read(signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+                    if (info.ssi_signo == SIGUSR1) {
+                        log_restart_stats();
+                        continue;
+                    }
+                    log_msg("INFO", "Received signal %d, initiating shutdown", (int)info.ssi_signo);
+                    running = false;
+                }
+            } else if (children.owns(fd)) {
+                exited.clear();
+                children.reap(fd, exited);
+                for (size_t e = 0; e < exited.size(); e++) child_exited(exited[e]);
+            }
+        }
+        if (running) restart_due();
+    }
+}
 
-        if (is_process_alive(lamp_pid)) {
-            log_msg("WARN", "Force killing lamp");
-            kill(lamp_pid, SIGKILL);
+// Ask a child to stop, and kill it if it has not within the timeout
+void stop_child(pid_t& pid, const char* name) {
+    if (pid <= 0) return;
+    log_msg("INFO", "Stopping %s (PID %d)", name, pid);
+    children.forget(pid);
+    kill(pid, SIGTERM);
+
+    bool exited = false;
+    for (long long waited = 0; waited < limits.shutdown_ms; waited += 100) {
+        if (waitpid(pid, NULL, WNOHANG) != 0) {
+            exited = true;
+            break;
         }
-        lamp_pid = -1;
+        usleep(100000);
     }
+    if (!exited) {
+        log_msg("WARN", "Force killing %s", name);
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+    }
+    pid = -1;
+}
+
+// Cleanup and shutdown
+void cleanup() {
+    log_msg("INFO", "Cleaning up...");
+
+    log_restart_stats();
+
+    // Stop genie_lamp first (no more gestures)
+    stop_child(genie_pid, "genie_lamp");
+
+    // Stop lamp, closing its pipe first
+    if (lamp_pipe_fd >= 0) {
+        close(lamp_pipe_fd);
+        lamp_pipe_fd = -1;
+    }
+    stop_child(lamp_pid, "lamp");
 
     // Remove pipe
     unlink(LAMP_PIPE);
@@ -342,13 +551,25 @@ int main(int argc, char** argv) {
     log_msg("INFO", "=== Elxnk starting ===");
     log_msg("INFO", "PID: %d", getpid());
 
+    // Restart policy from the config file
+    load_config(argc > 1 ? argv[1] : ELXNK_CONFIG);
+    for (size_t i = 0; i < sizeof(supervised) / sizeof(supervised[0]); i++) {
+        supervised[i]->policy.reseed((unsigned)(time(NULL) ^ getpid()) + i);
+    }
+
     // Write PID file
     if (!write_pid_file()) {
         return 1;
     }
 
-    // Setup signal handlers
-    setup_signals();
+    // Setup signal handling and the child watch
+    if (!setup_signals()) {
+        cleanup();
+        return 1;
+    }
+
+    // Without it genie_lamp takes lamp's strokes for a hand's, nothing worse
+    create_run_dir();
 
     // Create lamp pipe
     if (!create_lamp_pipe()) {
@@ -357,7 +578,7 @@ int main(int argc, char** argv) {
     }
 
     // Start lamp
-    if (!start_lamp()) {
+    if (!start_child(lamp_child)) {
         cleanup();
         return 1;
     }
@@ -368,7 +589,7 @@ int main(int argc, char** argv) {
     }
 
     // Start genie_lamp
-    if (!start_genie()) {
+    if (!start_child(genie_child)) {
         cleanup();
         return 1;
     }
@@ -377,11 +598,8 @@ int main(int argc, char** argv) {
     printf("Elxnk is running. Check %s for logs.\n", LOG_FILE);
     printf("Use 'kill %d' or Ctrl+C to stop.\n\n", getpid());
 
-    // Main loop - monitor processes
-    while (running) {
-        monitor_processes();
-        sleep(5);
-    }
+    // Main loop - restart children as they exit
+    supervise();
 
     log_msg("INFO", "Shutdown requested");
     cleanup();
@@ -0,0 +1,144 @@
+// Lamp Pen - tells genie_lamp which pen strokes lamp drew
+//
+// lamp draws by writing events into the real stylus device, so that xochitl
+// inks them. genie_lamp reads the same device to hold touch gestures off
+// while a hand writes, and would take lamp's strokes (a list redraw it asked
+// for, say) for writing too. So lamp publishes when it draws, in a small
+// file genie_lamp maps read only: the window [since, until] on
+// CLOCK_MONOTONIC, the clock genie_lamp's event timestamps use. Every pen
+// frame lamp writes extends until by LAMP_PEN_LEASE_US, and lifting the pen
+// closes it. A BTN_TOUCH down stamped inside the window is lamp's, and so is
+// the up that ends it; any other is a hand's.
+//
+// Nothing is counted, so neither side can fall out of step: a restart of
+// either, events lost to SYN_DROPPED or a stylus opened late only affect
+// the stroke in progress, and a lamp that dies mid-stroke lets the window
+// lapse within the lease.
+//
+// The file lives in LAMP_PEN_DIR, which the elxnk service creates. lamp
+// creates the file (0644); without it every pen-down is a hand's.
+
+#ifndef ELXNK_LAMP_PEN_H
+#define ELXNK_LAMP_PEN_H
+
+#include <linux/input.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "latency.h"
+
+namespace elxnk {
+
+#define LAMP_PEN_DIR "/run/elxnk"
+#define LAMP_PEN_FILE LAMP_PEN_DIR "/lamp_pen"
+
+// How long a pen frame keeps lamp's window open (microseconds)
+#define LAMP_PEN_LEASE_US 250000
+
+// Shared layout: lamp writes, genie_lamp reads
+struct LampPenWindow {
+    int64_t since;      // First pen-down of lamp's drawing (monotonic us)
+    int64_t until;      // Window end: lease, or when lamp lifted the pen
+};
+
+class LampPen {
+private:
+    LampPenWindow* window;
+    bool writable;
+    bool drawing;               // lamp: the pen is down for lamp
+    bool lamp_stroke;           // genie_lamp: the pen is down for lamp
+
+    bool map(const char* path, bool write) {
+        int fd = ::open(path, write ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            if (write || errno != ENOENT) perror(path);
+            return false;
+        }
+        struct stat st;
+        bool sized = fstat(fd, &st) == 0 && (st.st_size >= (off_t)sizeof(*window) ||
+                                             (write && ftruncate(fd, sizeof(*window)) == 0));
+        void* p = sized ? mmap(NULL, sizeof(*window), write ? PROT_READ | PROT_WRITE : PROT_READ,
+                               MAP_SHARED, fd, 0)
+                        : MAP_FAILED;
+        close(fd);
+        if (p == MAP_FAILED) {
+            if (write || sized) perror(path);
+            return false;
+        }
+        window = (LampPenWindow*)p;
+        writable = write;
+        return true;
+    }
+
+public:
+    LampPen() : window(NULL), writable(false), drawing(false), lamp_stroke(false) {}
+
+    ~LampPen() {
+        if (window) munmap(window, sizeof(*window));
+    }
+
+    // lamp: create the file and close any window a previous lamp left open
+    bool create(const char* path = LAMP_PEN_FILE) {
+        if (!map(path, true)) return false;
+        __atomic_store_n(&window->until, 0, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // genie_lamp: map the file read only; false until lamp has created it
+    bool open(const char* path = LAMP_PEN_FILE) {
+        return window || map(path, false);
+    }
+
+    // lamp: about to write a stylus frame, down if it puts the pen down
+    void before_frame(bool down) {
+        if (!writable) return;
+        long long now = monotonic_us();
+        if (down) {
+            // A new window unless the last one only just closed, so a
+            // stroke genie_lamp has not read yet stays inside it
+            if (now > __atomic_load_n(&window->until, __ATOMIC_RELAXED) + LAMP_PEN_LEASE_US) {
+                __atomic_store_n(&window->since, now, __ATOMIC_RELEASE);
+            }
+            drawing = true;
+        }
+        if (drawing) __atomic_store_n(&window->until, now + LAMP_PEN_LEASE_US, __ATOMIC_RELEASE);
+    }
+
+    // lamp: a frame lifting the pen was written
+    void after_up() {
+        if (!writable || !drawing) return;
+        drawing = false;
+        __atomic_store_n(&window->until, (int64_t)monotonic_us(), __ATOMIC_RELEASE);
+    }
+
+    // genie_lamp: whether a stylus event belongs to a stroke of lamp's
+    bool owns(const struct input_event& ev) {
+        if (ev.type != EV_KEY || ev.code != BTN_TOUCH) return false;
+        if (!ev.value) {
+            bool was = lamp_stroke;
+            lamp_stroke = false;
+            return was;
+        }
+        lamp_stroke = false;
+        if (!open()) return false;
+        long long t = (long long)ev.time.tv_sec * 1000000 + ev.time.tv_usec;
+        // until first: lamp stores since before the until that covers it
+        long long until = __atomic_load_n(&window->until, __ATOMIC_ACQUIRE);
+        long long since = __atomic_load_n(&window->since, __ATOMIC_ACQUIRE);
+        lamp_stroke = since > 0 && t >= since && t <= until;
+        return lamp_stroke;
+    }
+
+    // genie_lamp: stylus state was lost (SYN_DROPPED, device reopened)
+    void reset() {
+        lamp_stroke = false;
+    }
+};
+
+}  // namespace elxnk
+
+#endif  // ELXNK_LAMP_PEN_H
@@ -0,0 +1,98 @@
+// Latency - gesture-to-ink tracing shared by genie_lamp and lamp
+//
+// A gesture gets a trace ID when genie_lamp recognizes it, along with the
+// kernel timestamp of the input event that completed it. Every stage it
+// passes through records its duration into a histogram of that stage:
+//
+//   recognize    input event (kernel timestamp) -> gesture recognized
+//   dispatch     recognized -> action queued for the worker
+//   queue        queued -> worker picked it up
+//   generate     picked up -> lamp commands ready to send
+//   first write  sent to lamp -> first pen event written by lamp
+//   total        input event -> first pen event (gesture to ink)
+//
+// The first four are measured in genie_lamp, the last two in lamp. The trace
+// crosses the lamp pipe as one line ahead of the commands it covers:
+//
+//   trace <id> <event_us> <sent_us>
+//
+// All times are CLOCK_MONOTONIC microseconds, the clock genie_lamp sets its
+// input devices to, so both sides compare directly. A lamp without tracing
+// ignores the line.
+//
+// Histograms are log2 buckets of microseconds, updated with relaxed atomics
+// so a dump can read them while another thread records.
+
+#ifndef ELXNK_LATENCY_H
+#define ELXNK_LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+
+namespace elxnk {
+
+#define LATENCY_BUCKETS 26      // Up to 2^25 us (33 s); slower lands in the last
+
+inline long long monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+class LatencyHistogram {
+private:
+    const char* stage;
+    std::atomic<unsigned long> buckets[LATENCY_BUCKETS];    // [i]: below 2^i us
+    std::atomic<unsigned long> count;
+    std::atomic<unsigned long long> sum_us;
+    std::atomic<long long> max_us;
+
+    static int bucket(long long us) {
+        int b = 0;
+        while (b < LATENCY_BUCKETS - 1 && us >= (1LL << b)) b++;
+        return b;
+    }
+
+    // Upper bound of the bucket holding the given fraction of samples
+    long long percentile(double fraction, unsigned long total) const {
+        unsigned long want = (unsigned long)(total * fraction + 0.5), seen = 0;
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            seen += buckets[b].load(std::memory_order_relaxed);
+            if (seen >= want && seen > 0) return 1LL << b;
+        }
+        return 1LL << (LATENCY_BUCKETS - 1);
+    }
+
+public:
+    explicit LatencyHistogram(const char* stage_name)
+        : stage(stage_name), count(0), sum_us(0), max_us(0) {
+        for (int b = 0; b < LATENCY_BUCKETS; b++) buckets[b].store(0, std::memory_order_relaxed);
+    }
+
+    void add(long long us) {
+        if (us < 0) us = 0;         // Clock read on another CPU, or no timestamp
+        buckets[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum_us.fetch_add(us, std::memory_order_relaxed);
+        long long max = max_us.load(std::memory_order_relaxed);
+        while (us > max && !max_us.compare_exchange_weak(max, us, std::memory_order_relaxed)) {}
+    }
+
+    // One line: samples, mean, percentiles (as bucket upper bounds), max
+    void print(FILE* out) const {
+        unsigned long n = count.load(std::memory_order_relaxed);
+        if (n == 0) {
+            fprintf(out, "  %-12s no samples\n", stage);
+            return;
+        }
+        fprintf(out, "  %-12s %6lu  mean %8.0f us  p50 <%lld  p90 <%lld  p99 <%lld  max %lld us\n", stage, n,
+                (double)sum_us.load(std::memory_order_relaxed) / n, percentile(0.50, n), percentile(0.90, n),
+                percentile(0.99, n), max_us.load(std::memory_order_relaxed));
+    }
+};
+
+}  // namespace elxnk
+
+#endif  // ELXNK_LATENCY_H
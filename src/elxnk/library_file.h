@@ -0,0 +1,279 @@
+// Binary Library Files - mmap'd component and glyph libraries
+// Lets lamp and render_component pick up new assets without a rebuild
+//
+// FILE LAYOUT (version 2, little endian, written by svgc --binary):
+//   LibraryHeader                  - 32 bytes at offset 0
+//   LibraryEntry[entry_count]      - Index at index_offset, sorted by (kind, name)
+//   uint8_t[data_size]             - Packed strokes at data_offset (stroke_codec.h)
+//
+// Version 1 stored 12-byte fixed ops and is no longer read.
+//
+// Opening a file maps it read-only and validates the header and section
+// bounds; nothing else is read or parsed. Lookups binary-search the index and
+// the kernel pages in only the entries and ops that are actually drawn, so
+// startup cost does not grow with the library.
+//
+// Several files can be loaded at once. Later files override earlier ones and
+// the library compiled into the binary is the fallback for anything missing.
+
+#ifndef ELXNK_LIBRARY_FILE_H
+#define ELXNK_LIBRARY_FILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include "component_library.h"
+#include "stroke_codec.h"
+
+namespace elxnk {
+
+#define LIBRARY_MAGIC "ELXL"
+#define LIBRARY_VERSION 2
+#define LIBRARY_NAME_LEN 16
+
+// Default search path when ELXNK_LIBRARY_PATH is not set
+#define LIBRARY_DEFAULT_PATH "/opt/share/elxnk"
+
+enum LibraryKind {
+    LIBRARY_COMPONENT = 0,
+    LIBRARY_GLYPH = 1
+};
+
+struct LibraryHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t lod_count;       // Must match LOD_COUNT
+    uint16_t orient_count;    // Must match ORIENT_COUNT
+    uint16_t entry_size;      // Must match sizeof(LibraryEntry)
+    uint32_t entry_count;
+    uint32_t index_offset;
+    uint32_t data_offset;
+    uint32_t data_size;
+    uint32_t reserved;
+};
+
+struct LibraryVariant {
+    uint32_t offset;          // Byte offset into the stroke data
+    uint32_t count;           // Commands
+};
+
+struct LibraryEntry {
+    char name[LIBRARY_NAME_LEN];  // NUL terminated; glyphs use a single character
+    uint8_t kind;
+    uint8_t pad[3];
+    float error[LOD_COUNT];
+    LibraryVariant variants[LOD_COUNT][ORIENT_COUNT];  // Glyphs repeat ORIENT_R0
+};
+
+// One mapped library file
+class LibraryFile {
+private:
+    std::string path;
+    void* map;
+    size_t size;
+    const LibraryHeader* header;
+    const LibraryEntry* entries;
+    const uint8_t* data;
+
+    LibraryFile(const LibraryFile&);
+    LibraryFile& operator=(const LibraryFile&);
+
+    bool fail(const char* reason, char* err, size_t err_len) {
+        if (err) snprintf(err, err_len, "%s: %s", path.c_str(), reason);
+        close();
+        return false;
+    }
+
+    static int compare(int kind, const char* name, const LibraryEntry& e) {
+        if (kind != e.kind) return kind < e.kind ? -1 : 1;
+        return strncmp(name, e.name, LIBRARY_NAME_LEN);
+    }
+
+public:
+    LibraryFile() : map(NULL), size(0), header(NULL), entries(NULL), data(NULL) {}
+    ~LibraryFile() { close(); }
+
+    // Map and validate a library file. On failure a reason is written to err.
+    bool open(const char* file, char* err = NULL, size_t err_len = 0) {
+        close();
+        path = file;
+
+        int fd = ::open(file, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return fail(strerror(errno), err, err_len);
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(LibraryHeader)) {
+            ::close(fd);
+            return fail("too small", err, err_len);
+        }
+
+        size = st.st_size;
+        map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            map = NULL;
+            return fail(strerror(errno), err, err_len);
+        }
+
+        const LibraryHeader* h = (const LibraryHeader*)map;
+        if (memcmp(h->magic, LIBRARY_MAGIC, 4) != 0) return fail("not a library file", err, err_len);
+        if (h->version != LIBRARY_VERSION) return fail("unsupported version", err, err_len);
+        if (h->lod_count != LOD_COUNT || h->orient_count != ORIENT_COUNT ||
+            h->entry_size != sizeof(LibraryEntry)) {
+            return fail("built for a different library layout", err, err_len);
+        }
+        if ((uint64_t)h->index_offset + (uint64_t)h->entry_count * sizeof(LibraryEntry) > size ||
+            (uint64_t)h->data_offset + h->data_size > size ||
+            h->index_offset % 4 != 0) {
+            return fail("truncated", err, err_len);
+        }
+
+        header = h;
+        entries = (const LibraryEntry*)((const char*)map + h->index_offset);
+        data = (const uint8_t*)map + h->data_offset;
+        return true;
+    }
+
+    void close() {
+        if (map) munmap(map, size);
+        map = NULL;
+        size = 0;
+        header = NULL;
+        entries = NULL;
+        data = NULL;
+    }
+
+    bool is_open() const { return header != NULL; }
+    const char* get_path() const { return path.c_str(); }
+    size_t get_size() const { return size; }
+    int get_entry_count() const { return header ? (int)header->entry_count : 0; }
+    const LibraryEntry& get_entry(int i) const { return entries[i]; }
+
+    // Binary search of the index
+    const LibraryEntry* find(int kind, const char* name) const {
+        if (!header) return NULL;
+        int lo = 0;
+        int hi = (int)header->entry_count - 1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            int c = compare(kind, name, entries[mid]);
+            if (c == 0) return &entries[mid];
+            if (c < 0) hi = mid - 1;
+            else lo = mid + 1;
+        }
+        return NULL;
+    }
+
+    // Packed strokes of one variant, or NULL if it lies outside the file.
+    // avail is set to the bytes left in the stroke data, which bounds decoding.
+    const uint8_t* get_strokes(const LibraryVariant& v, size_t& avail) const {
+        if (!header || v.offset >= header->data_size) return NULL;
+        avail = header->data_size - v.offset;
+        return data + v.offset;
+    }
+};
+
+// Stack of library files searched from the most recently loaded one
+class LibrarySet {
+private:
+    std::vector<LibraryFile*> files;
+
+    LibrarySet(const LibrarySet&);
+    LibrarySet& operator=(const LibrarySet&);
+
+    // Load every *.elxl in a directory in name order
+    void load_directory(const char* dir) {
+        std::string pattern = std::string(dir) + "/*.elxl";
+        glob_t g;
+        if (glob(pattern.c_str(), 0, NULL, &g) == 0) {
+            for (size_t i = 0; i < g.gl_pathc; i++) load(g.gl_pathv[i]);
+        }
+        globfree(&g);
+    }
+
+public:
+    LibrarySet() {}
+    ~LibrarySet() {
+        for (size_t i = 0; i < files.size(); i++) delete files[i];
+    }
+
+    // Add a file on top of the stack; errors are reported on stderr
+    bool load(const char* path) {
+        char err[256];
+        LibraryFile* f = new LibraryFile();
+        if (!f->open(path, err, sizeof(err))) {
+            fprintf(stderr, "elxnk: library %s\n", err);
+            delete f;
+            return false;
+        }
+        files.push_back(f);
+        return true;
+    }
+
+    // Load files and directories from ELXNK_LIBRARY_PATH (colon separated),
+    // or every library in LIBRARY_DEFAULT_PATH. Returns the number of files loaded.
+    int load_default() {
+        const char* env = getenv("ELXNK_LIBRARY_PATH");
+        std::string search = env ? env : LIBRARY_DEFAULT_PATH;
+        size_t before = files.size();
+
+        size_t start = 0;
+        while (start <= search.size()) {
+            size_t end = search.find(':', start);
+            if (end == std::string::npos) end = search.size();
+            std::string item = search.substr(start, end - start);
+            start = end + 1;
+            if (item.empty()) continue;
+
+            struct stat st;
+            if (stat(item.c_str(), &st) < 0) {
+                if (env) fprintf(stderr, "elxnk: library %s: %s\n", item.c_str(), strerror(errno));
+            } else if (S_ISDIR(st.st_mode)) {
+                load_directory(item.c_str());
+            } else {
+                load(item.c_str());
+            }
+        }
+
+        return (int)(files.size() - before);
+    }
+
+    int get_file_count() const { return (int)files.size(); }
+    const LibraryFile& get_file(int i) const { return *files[i]; }
+
+    // Find an asset in the loaded files; file is set to the one that has it
+    const LibraryEntry* find(int kind, const char* name, const LibraryFile** file) const {
+        for (size_t i = files.size(); i-- > 0;) {
+            const LibraryEntry* e = files[i]->find(kind, name);
+            if (e) {
+                if (file) *file = files[i];
+                return e;
+            }
+        }
+        return NULL;
+    }
+
+    const LibraryEntry* find_glyph(char c, const LibraryFile** file) const {
+        char name[2] = { c, '\0' };
+        return find(LIBRARY_GLYPH, name, file);
+    }
+};
+
+// Process-wide library set used by the render engine
+inline LibrarySet& library() {
+    static LibrarySet set;
+    return set;
+}
+
+}  // namespace elxnk
+
+#endif  // ELXNK_LIBRARY_FILE_H
@@ -1,10 +1,12 @@
 // Component Renderer - Uses embedded component_library.h
+// plus any library files found on ELXNK_LIBRARY_PATH (default /opt/share/elxnk)
 // Renders components by sending lamp commands to the pipe
-// This is the binary that actually USES the embedded library!
+// Shares its render engine (renderer.h) with lamp, which accepts the same
+// placement requests directly: echo "place R 500 500 1.0" > /tmp/elxnk_lamp.pipe
 //
 // COORDINATE SYSTEM (PIXEL-SCALE VERSION):
 //   - Component library: Pixel coordinates at 10 px/mm scale (e.g., R is 22x78 pixels)
-//   - This binary: Applies scale + offset to get ABSOLUTE screen pixels (0-1404, 0-1872)
+//   - This binary: Applies orientation, scale + offset to get ABSOLUTE screen pixels (0-1404, 0-1872)
 //   - Lamp receives: Absolute pixel coordinates for reMarkable 2 display
 //
 //   Example: Component R has "pen down 11 16" (at 10px/mm, normalized to origin)
@@ -20,188 +22,252 @@
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <ctype.h>
-#include "component_library.h"
+#include <string>
+#include "renderer.h"
+#include "schematic.h"
+#include "asset_metadata.h"
 
 #define LAMP_PIPE "/tmp/elxnk_lamp.pipe"
 
 void print_usage(const char* prog) {
-    printf("Usage: %s <component|text> <x> <y> [scale]\n", prog);
+    printf("Usage: %s <component|text> <x> <y> [scale] [transform]\n", prog);
     printf("\nCommands:\n");
     printf("  list              - List all available components\n");
     printf("  <name> <x> <y>    - Render component at position\n");
+    printf("  center <name> <x> <y> [scale] [transform]\n");
+    printf("                    - Render component centered on position\n");
+    printf("  pins <name> <x> <y> [scale] [transform]\n");
+    printf("                    - Print where the pins of a placement land\n");
+    printf("\nTransforms:\n");
+    printf("  rot90 rot180 rot270, mirror mirror90 mirror180 mirror270,\n");
+    printf("  rot<degrees>, matrix <a> <b> <c> <d> (rotation/mirror, uniform scale)\n");
+    printf("\nModes:\n");
     printf("  text <x> <y> <string> - Render text\n");
+    printf("  -                 - Read placement requests from stdin\n");
+    printf("  schematic <file>  - Render a whole schematic ('-' for stdin)\n");
     printf("\nExamples:\n");
     printf("  %s R 500 500           # Render resistor\n", prog);
+    printf("  %s R 500 500 1.0 rot90 # Render resistor rotated 90 degrees\n", prog);
+    printf("  %s center R 702 936    # Render resistor centered on screen\n", prog);
     printf("  %s list                # Show all components\n", prog);
     printf("  %s text 100 100 ABC    # Render text 'ABC'\n", prog);
+    printf("  echo 'place R 500 500' | %s -\n", prog);
 }
 
 // List all available components
 void list_components() {
-    printf("Available Components (%d):\n", elxnk::COMPONENT_COUNT);
-    for (int i = 0; i < elxnk::COMPONENT_COUNT; i++) {
-        printf("  %-10s (%d commands)\n",
-               elxnk::COMPONENTS[i].name,
-               elxnk::COMPONENTS[i].count);
-    }
-    printf("\nAvailable Font Glyphs (%d):\n", elxnk::FONT_GLYPH_COUNT);
-    for (int i = 0; i < elxnk::FONT_GLYPH_COUNT; i++) {
-        printf("  '%c' (%d commands)\n",
-               elxnk::FONT_GLYPHS[i].character,
-               elxnk::FONT_GLYPHS[i].count);
+    const elxnk::LibrarySet& set = elxnk::library();
+    for (int f = 0; f < set.get_file_count(); f++) {
+        const elxnk::LibraryFile& file = set.get_file(f);
+        printf("Library %s (%d assets, %zu bytes):\n",
+               file.get_path(), file.get_entry_count(), file.get_size());
+        for (int i = 0; i < file.get_entry_count(); i++) {
+            const elxnk::LibraryEntry& e = file.get_entry(i);
+            printf("  %s%-10s (LOD", e.kind == elxnk::LIBRARY_GLYPH ? "glyph " : "", e.name);
+            for (int lod = 0; lod < LOD_COUNT; lod++) {
+                printf("%c%u", lod ? '/' : ' ', e.variants[lod][elxnk::ORIENT_R0].count);
+            }
+            printf(")\n");
+        }
+        printf("\n");
     }
-}
 
-// Send component to lamp pipe
-void render_component(const char* name, int x, int y, float scale) {
-    // Find component
-    const elxnk::Component* comp = elxnk::find_component(name);
-    if (!comp) {
-        fprintf(stderr, "Error: Component '%s' not found\n", name);
-        fprintf(stderr, "Use 'list' to see available components\n");
-        return;
+    printf("Available Components (%d):\n", elxnk::get_component_count());
+    for (int i = 0; i < elxnk::get_component_count(); i++) {
+        const elxnk::Component& comp = elxnk::get_component(i);
+        printf("  %-10s (%d commands, %u bytes, %.1f ms, LOD", comp.name, comp.count, comp.size,
+               comp.levels[0][elxnk::ORIENT_R0].draw_us / 1000.0);
+        for (int lod = 0; lod < LOD_COUNT; lod++) {
+            printf("%c%d", lod ? '/' : ' ', comp.levels[lod][elxnk::ORIENT_R0].count);
+        }
+        printf(")");
+        const elxnk::ComponentInfo* info = elxnk::component_info(comp.name);
+        if (info) {
+            printf(" %dx%d, pins", info->bounds.width(), info->bounds.height());
+            for (int k = 0; k < info->pin_count; k++) printf(" %d,%d", info->pins[k].x, info->pins[k].y);
+            if (!info->pin_count) printf(" none");
+        }
+        printf("\n");
+    }
+    printf("\nAvailable Font Glyphs (%d):\n", elxnk::get_glyph_count());
+    for (int i = 0; i < elxnk::get_glyph_count(); i++) {
+        const elxnk::FontGlyph& glyph = elxnk::get_glyph(i);
+        printf("  '%c' (%d commands, %u bytes, %.1f ms, LOD", glyph.character, glyph.count, glyph.size,
+               glyph.levels[0].draw_us / 1000.0);
+        for (int lod = 0; lod < LOD_COUNT; lod++) {
+            printf("%c%d", lod ? '/' : ' ', glyph.levels[lod].count);
+        }
+        printf(")\n");
     }
+}
 
-    // Open lamp pipe
+// Open lamp pipe for writing
+int open_lamp_pipe() {
     int fd = open(LAMP_PIPE, O_WRONLY);
     if (fd < 0) {
         perror("Failed to open lamp pipe");
         fprintf(stderr, "Is elxnk running?\n");
-        return;
-    }
-
-    printf("Rendering %s at (%d, %d) scale=%.2f (%d commands)\n",
-           name, x, y, scale, comp->count);
-
-    // Send commands
-    for (int i = 0; i < comp->count; i++) {
-        const char* cmd = comp->commands[i].cmd;
-        char transformed[256];
-
-        // Transform pen down X Y
-        if (strncmp(cmd, "pen down ", 9) == 0) {
-            int cx, cy;
-            if (sscanf(cmd + 9, "%d %d", &cx, &cy) == 2) {
-                cx = (int)(cx * scale) + x;
-                cy = (int)(cy * scale) + y;
-                snprintf(transformed, sizeof(transformed), "pen down %d %d\n", cx, cy);
-                write(fd, transformed, strlen(transformed));
-                continue;
-            }
-        }
+    }
+    return fd;
+}
 
-        // Transform pen move X Y
-        if (strncmp(cmd, "pen move ", 9) == 0) {
-            int cx, cy;
-            if (sscanf(cmd + 9, "%d %d", &cx, &cy) == 2) {
-                cx = (int)(cx * scale) + x;
-                cy = (int)(cy * scale) + y;
-                snprintf(transformed, sizeof(transformed), "pen move %d %d\n", cx, cy);
-                write(fd, transformed, strlen(transformed));
-                continue;
-            }
-        }
+// Send component to lamp pipe
+int render_component(const char* name, const elxnk::Placement& placement) {
+    // Find component (library files override the embedded library)
+    const elxnk::Component* comp = elxnk::find_component(name);
+    const elxnk::LibraryEntry* entry =
+        elxnk::library().find(elxnk::LIBRARY_COMPONENT, name, NULL);
+    if (!comp && !entry) {
+        fprintf(stderr, "Error: Component '%s' not found\n", name);
+        fprintf(stderr, "Use 'list' to see available components\n");
+        return 1;
+    }
 
-        // Transform pen circle X Y R1 R2
-        if (strncmp(cmd, "pen circle ", 11) == 0) {
-            int cx, cy, r1, r2;
-            if (sscanf(cmd + 11, "%d %d %d %d", &cx, &cy, &r1, &r2) == 4) {
-                cx = (int)(cx * scale) + x;
-                cy = (int)(cy * scale) + y;
-                r1 = (int)(r1 * scale);
-                r2 = (int)(r2 * scale);
-                snprintf(transformed, sizeof(transformed), "pen circle %d %d %d %d\n", cx, cy, r1, r2);
-                write(fd, transformed, strlen(transformed));
-                continue;
-            }
-        }
+    int fd = open_lamp_pipe();
+    if (fd < 0) return 1;
 
-        // Send as-is (pen up, etc.)
-        write(fd, cmd, strlen(cmd));
-        write(fd, "\n", 1);
+    printf("Rendering %s at (%d, %d) scale=%.2f (%s)\n",
+           name, placement.x, placement.y, placement.scale,
+           entry ? "library file" : "embedded");
+
+    {
+        elxnk::LampTextSink sink(fd);
+        elxnk::render_component(sink, name, placement);
     }
 
     close(fd);
+    return 0;
 }
 
-// Render text using font glyphs
-void render_text(int x, int y, const char* text, float scale, int spacing) {
-    int fd = open(LAMP_PIPE, O_WRONLY);
-    if (fd < 0) {
-        perror("Failed to open lamp pipe");
-        return;
+// Anchor an affine placement on the component's box, as render_component() does
+void anchor_placement(const elxnk::ComponentInfo* info, elxnk::Placement& placement) {
+    if (!placement.affine) return;
+    elxnk::StrokeBounds b = {info->bounds.x0, info->bounds.y0, info->bounds.x1, info->bounds.y1};
+    placement.anchor(b);
+}
+
+// Move the placement so the component's bounding box is centered on (x, y).
+// Returns false if the component has no metadata (library files only).
+bool center_placement(const char* name, elxnk::Placement& placement) {
+    const elxnk::ComponentInfo* info = elxnk::component_info(name);
+    if (!info) return false;
+    anchor_placement(info, placement);
+
+    elxnk::AssetBounds b = elxnk::oriented_bounds(info->bounds, elxnk::placement_orientation(placement));
+    int cx = placement.x, cy = placement.y;
+    int ox, oy;
+    placement.x = placement.y = 0;
+    placement.map(b.x0 + b.width() / 2, b.y0 + b.height() / 2, ox, oy);
+    placement.x = cx - ox;
+    placement.y = cy - oy;
+    return true;
+}
+
+// Print the screen position of every pin of a placement
+int print_pins(const char* name, elxnk::Placement placement) {
+    const elxnk::ComponentInfo* info = elxnk::component_info(name);
+    if (!info) {
+        fprintf(stderr, "Error: No metadata for '%s' (embedded components only)\n", name);
+        return 1;
+    }
+    anchor_placement(info, placement);
+
+    int orientation = elxnk::placement_orientation(placement);
+    printf("%s: %d pin(s)%s\n", info->name, info->pin_count, info->pins_marked ? " (marked)" : "");
+    for (int k = 0; k < info->pin_count; k++) {
+        elxnk::AssetPoint pin = elxnk::oriented_point(info->bounds, info->pins[k], orientation);
+        int x, y;
+        placement.map(pin.x, pin.y, x, y);
+        printf("  pin %d: %d %d\n", k + 1, x, y);
     }
+    return 0;
+}
+
+// Render text using font glyphs
+int render_text(int x, int y, const char* text, float scale) {
+    int fd = open_lamp_pipe();
+    if (fd < 0) return 1;
 
     printf("Rendering text: '%s' at (%d, %d)\n", text, x, y);
 
-    int offset_x = x;
-    for (const char* p = text; *p; p++) {
-        char c = toupper(*p);
+    int missing;
+    {
+        elxnk::LampTextSink sink(fd);
+        missing = elxnk::render_text(sink, x, y, text, scale);
+    }
+    if (missing > 0) {
+        fprintf(stderr, "Warning: %d character(s) have no glyph\n", missing);
+    }
 
-        if (c == ' ') {
-            offset_x += spacing;
-            continue;
-        }
+    close(fd);
+    return 0;
+}
 
-        const elxnk::FontGlyph* glyph = elxnk::find_glyph(c);
-        if (!glyph) {
-            fprintf(stderr, "Warning: Glyph '%c' not found\n", c);
-            offset_x += spacing;
-            continue;
+// Expand placement requests from stdin into lamp commands on the pipe.
+// Lines that are not placement requests are forwarded unchanged.
+int render_stream() {
+    int fd = open_lamp_pipe();
+    if (fd < 0) return 1;
+
+    elxnk::LampTextSink sink(fd);
+    char line[512];
+    char err[128];
+    int lineno = 0;
+
+    while (fgets(line, sizeof(line), stdin)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+
+        elxnk::RequestStatus status = elxnk::handle_request(sink, line, err, sizeof(err));
+        if (status == elxnk::REQUEST_NONE) {
+            sink.raw(line);
+        } else if (status == elxnk::REQUEST_ERROR) {
+            fprintf(stderr, "Line %d: %s\n", lineno, err);
         }
+    }
 
-        // Render glyph
-        for (int i = 0; i < glyph->count; i++) {
-            const char* cmd = glyph->commands[i].cmd;
-            char transformed[256];
-
-            // Transform pen down X Y
-            if (strncmp(cmd, "pen down ", 9) == 0) {
-                int gx, gy;
-                if (sscanf(cmd + 9, "%d %d", &gx, &gy) == 2) {
-                    gx = (int)(gx * scale) + offset_x;
-                    gy = (int)(gy * scale) + y;
-                    snprintf(transformed, sizeof(transformed), "pen down %d %d\n", gx, gy);
-                    write(fd, transformed, strlen(transformed));
-                    continue;
-                }
-            }
+    sink.flush();
+    close(fd);
+    return 0;
+}
 
-            // Transform pen move X Y
-            if (strncmp(cmd, "pen move ", 9) == 0) {
-                int gx, gy;
-                if (sscanf(cmd + 9, "%d %d", &gx, &gy) == 2) {
-                    gx = (int)(gx * scale) + offset_x;
-                    gy = (int)(gy * scale) + y;
-                    snprintf(transformed, sizeof(transformed), "pen move %d %d\n", gx, gy);
-                    write(fd, transformed, strlen(transformed));
-                    continue;
-                }
-            }
+// Render a schematic file as one ordered stroke stream
+int render_schematic(const char* path) {
+    FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!in) {
+        perror("Failed to open schematic");
+        return 1;
+    }
 
-            // Transform pen circle X Y R1 R2
-            if (strncmp(cmd, "pen circle ", 11) == 0) {
-                int gx, gy, r1, r2;
-                if (sscanf(cmd + 11, "%d %d %d %d", &gx, &gy, &r1, &r2) == 4) {
-                    gx = (int)(gx * scale) + offset_x;
-                    gy = (int)(gy * scale) + y;
-                    r1 = (int)(r1 * scale);
-                    r2 = (int)(r2 * scale);
-                    snprintf(transformed, sizeof(transformed), "pen circle %d %d %d %d\n", gx, gy, r1, r2);
-                    write(fd, transformed, strlen(transformed));
-                    continue;
-                }
-            }
+    int fd = open_lamp_pipe();
+    if (fd < 0) {
+        if (in != stdin) fclose(in);
+        return 1;
+    }
 
-            write(fd, cmd, strlen(cmd));
-            write(fd, "\n", 1);
-        }
+    elxnk::LampTextSink sink(fd);
+    elxnk::SchematicRenderer schematic(sink);
+    char line[1024];
 
-        offset_x += (int)(25 * scale);
+    while (fgets(line, sizeof(line), in)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!schematic.add_line(line)) {
+            fprintf(stderr, "Line %d: cannot parse '%s'\n", schematic.get_stats().lines, line);
+        }
     }
+    schematic.finish();
+    sink.flush();
 
+    const elxnk::SchematicStats& st = schematic.get_stats();
+    printf("Schematic: %d parts, %d wires (%d merged), %d dots, %d labels, "
+           "%ld px pen-up travel, %d errors\n",
+           st.placements, st.wires, st.wires_merged, st.dots, st.labels,
+           st.travel, st.errors);
+
+    if (in != stdin) fclose(in);
     close(fd);
+    return st.errors ? 1 : 0;
 }
 
 int main(int argc, char** argv) {
@@ -210,12 +276,28 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    elxnk::library().load_default();
+
     // List command
     if (strcmp(argv[1], "list") == 0) {
         list_components();
         return 0;
     }
 
+    // Stream mode
+    if (strcmp(argv[1], "-") == 0) {
+        return render_stream();
+    }
+
+    // Whole schematic
+    if (strcmp(argv[1], "schematic") == 0) {
+        if (argc < 3) {
+            fprintf(stderr, "Usage: %s schematic <file|->\n", argv[0]);
+            return 1;
+        }
+        return render_schematic(argv[2]);
+    }
+
     // Text command
     if (strcmp(argv[1], "text") == 0) {
         if (argc < 5) {
@@ -225,24 +307,53 @@ int main(int argc, char** argv) {
         int x = atoi(argv[2]);
         int y = atoi(argv[3]);
         float scale = (argc > 5) ? atof(argv[5]) : 1.0;
-        int spacing = 25;
 
-        render_text(x, y, argv[4], scale, spacing);
-        return 0;
+        return render_text(x, y, argv[4], scale);
     }
 
-    // Component rendering
-    if (argc < 4) {
-        fprintf(stderr, "Usage: %s <component> <x> <y> [scale]\n", argv[0]);
+    // Component rendering, optionally centered, or its pin positions
+    bool center = strcmp(argv[1], "center") == 0;
+    bool pins = strcmp(argv[1], "pins") == 0;
+    int first = (center || pins) ? 2 : 1;
+    if (argc < first + 3) {
+        fprintf(stderr, "Usage: %s %s<component> <x> <y> [scale] [transform]\n",
+                argv[0], center ? "center " : pins ? "pins " : "");
         return 1;
     }
 
-    const char* name = argv[1];
-    int x = atoi(argv[2]);
-    int y = atoi(argv[3]);
-    float scale = (argc > 4) ? atof(argv[4]) : 1.0;
-
-    render_component(name, x, y, scale);
+    const char* name = argv[first];
+    int x = atoi(argv[first + 1]);
+    int y = atoi(argv[first + 2]);
+    float scale = (argc > first + 3) ? atof(argv[first + 3]) : 1.0;
+    elxnk::Placement placement(x, y, scale);
+
+    if (argc > first + 4) {
+        // Remaining arguments are the transform (matrix takes four values)
+        std::string rest;
+        for (int i = first + 5; i < argc; i++) {
+            if (!rest.empty()) rest += ' ';
+            rest += argv[i];
+        }
+        int rest_used = 0;
+        if (!elxnk::parse_transform(argv[first + 4], rest.c_str(), placement, rest_used)) {
+            if (strcmp(argv[first + 4], "matrix") == 0) {
+                fprintf(stderr, "Error: matrix takes <a> <b> <c> <d> (rotation, mirror, uniform scale)\n");
+            } else {
+                fprintf(stderr, "Error: Unknown transform '%s'\n", argv[first + 4]);
+            }
+            return 1;
+        }
+        if (!elxnk::is_blank(rest.c_str() + rest_used)) {
+            fprintf(stderr, "Error: Unexpected '%s' after transform\n",
+                    rest.c_str() + rest_used + strspn(rest.c_str() + rest_used, " "));
+            return 1;
+        }
+    }
 
-    return 0;
+    if (pins) return print_pins(name, placement);
+    if (center && !center_placement(name, placement)) {
+        fprintf(stderr, "Error: No metadata for '%s', cannot center\n", name);
+        return 1;
+    }
+    return render_component(name, placement);
 }
@@ -0,0 +1,558 @@
+// Render Engine - shared by lamp and render_component
+// Turns placement requests into pen strokes using the loaded libraries
+//
+// lamp links this engine directly, so a placement is a single line written
+// to /tmp/elxnk_lamp.pipe instead of a render_component process per part.
+// render_component uses the same engine and writes lamp text to the pipe.
+//
+// PLACEMENT PROTOCOL (one request per line):
+//   place <name> <x> <y> [scale] [transform] - Draw component with origin at (x,y)
+//   text <x> <y> <scale> <string...>         - Draw text (rest of line is the string)
+//
+// TRANSFORMS:
+//   rot0 rot90 rot180 rot270            - Clockwise rotation (precomputed variant)
+//   mirror mirror90 mirror180 mirror270 - Mirror left-right, then rotate
+//   rot<deg>                            - Any angle, clockwise
+//   matrix <a> <b> <c> <d>              - x' = a*x + b*y, y' = c*x + d*y
+//                                         (rotation/mirror and uniform scale
+//                                         only: circles keep one radius scale)
+//
+// Nothing may follow the transform and its operands.
+// Orthogonal transforms select a build-time variant from the library, so the
+// hot path stays scale + translate; rot<deg> at a multiple of 90 and matrices
+// that are a scaled variant take the same path. Other angles and matrices
+// fall back to 16.16 fixed-point math per point. Either way the bounding box
+// keeps its top left corner, the way the variants were built.
+//
+// Every placement draws the coarsest level of detail whose simplification
+// error, multiplied by the effective scale, stays within LOD_MAX_ERROR_PX.
+//
+// Names are looked up in the mmap'd library files first (see library_file.h),
+// then in the library compiled into the binary.
+//
+// Anything else is not a placement request and is left to the caller.
+
+#ifndef ELXNK_RENDERER_H
+#define ELXNK_RENDERER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <math.h>
+#include "component_library.h"
+#include "library_file.h"
+#include "stroke_codec.h"
+
+namespace elxnk {
+
+// Horizontal advance of one glyph at scale 1.0 (pixels)
+#define GLYPH_ADVANCE 25
+
+// Largest simplification error allowed on screen (display pixels)
+#define LOD_MAX_ERROR_PX 1.0f
+
+// Receives the transformed strokes of a placement
+class StrokeSink {
+public:
+    virtual ~StrokeSink() {}
+    virtual void down(int x, int y) = 0;
+    virtual void move(int x, int y) = 0;
+    virtual void up() = 0;
+    virtual void circle(int cx, int cy, int r1, int r2) = 0;
+    // Library command the engine does not transform (sent as-is)
+    virtual void raw(const char* cmd) = 0;
+};
+
+// Writes lamp text commands to a file descriptor (lamp pipe or stdout).
+// Output is buffered and only flushed on line boundaries, so each write()
+// stays below PIPE_BUF and never interleaves with other pipe writers.
+class LampTextSink : public StrokeSink {
+private:
+    int fd;
+    char buf[4096];
+    size_t len;
+
+    void append(const char* line, int n) {
+        if (n <= 0) return;
+        if (len + n > sizeof(buf)) flush();
+        if ((size_t)n > sizeof(buf)) n = sizeof(buf);
+        memcpy(buf + len, line, n);
+        len += n;
+    }
+
+public:
+    explicit LampTextSink(int out_fd) : fd(out_fd), len(0) {}
+    ~LampTextSink() { flush(); }
+
+    void flush() {
+        size_t off = 0;
+        while (off < len) {
+            ssize_t n = write(fd, buf + off, len - off);
+            if (n <= 0) break;
+            off += n;
+        }
+        len = 0;
+    }
+
+    void down(int x, int y) {
+        char line[64];
+        append(line, snprintf(line, sizeof(line), "pen down %d %d\n", x, y));
+    }
+
+    void move(int x, int y) {
+        char line[64];
+        append(line, snprintf(line, sizeof(line), "pen move %d %d\n", x, y));
+    }
+
+    void up() {
+        append("pen up\n", 7);
+    }
+
+    void circle(int cx, int cy, int r1, int r2) {
+        char line[80];
+        append(line, snprintf(line, sizeof(line), "pen circle %d %d %d %d\n", cx, cy, r1, r2));
+    }
+
+    void raw(const char* cmd) {
+        char line[256];
+        append(line, snprintf(line, sizeof(line), "%s\n", cmd));
+    }
+};
+
+// 16.16 fixed point for arbitrary transforms
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+inline int to_fixed(double v) {
+    return (int)floor(v * FIXED_ONE + 0.5);
+}
+
+// Bounding box of a stroke list, points and circle extents (library pixels)
+struct StrokeBounds {
+    int x0, y0, x1, y1;
+};
+
+// Bounds of up to count packed commands, as svgc computes them for variants
+inline StrokeBounds stroke_bounds(const uint8_t* data, size_t size, int count) {
+    StrokeBounds b = {0, 0, 0, 0};
+    bool any = false;
+    StrokeDecoder decoder(data, size);
+    StrokeOp op;
+    for (int i = 0; i < count && decoder.next(op); i++) {
+        int xs[2], ys[2];
+        int n = 0;
+        if (op.op == OP_DOWN || op.op == OP_MOVE) {
+            xs[0] = op.a; ys[0] = op.b; n = 1;
+        } else if (op.op == OP_CIRCLE) {
+            xs[0] = op.a - op.c; ys[0] = op.b - op.d;
+            xs[1] = op.a + op.c; ys[1] = op.b + op.d;
+            n = 2;
+        }
+        for (int k = 0; k < n; k++) {
+            if (!any) {
+                b.x0 = b.x1 = xs[k];
+                b.y0 = b.y1 = ys[k];
+                any = true;
+            }
+            if (xs[k] < b.x0) b.x0 = xs[k];
+            if (ys[k] < b.y0) b.y0 = ys[k];
+            if (xs[k] > b.x1) b.x1 = xs[k];
+            if (ys[k] > b.y1) b.y1 = ys[k];
+        }
+    }
+    return b;
+}
+
+// Position, size and orientation of a placement
+struct Placement {
+    int x;
+    int y;
+    float scale;
+    int orientation;   // Orientation variant to draw (ORIENT_R0..ORIENT_MX270)
+    bool affine;       // Use m[] instead of scale (arbitrary angle / matrix)
+    int m[4];          // 16.16 linear part: x' = m0*x + m1*y, y' = m2*x + m3*y
+    int r_scale;       // 16.16 radius factor for circles under m[]
+    long long tx;      // 16.16 offset added after m[] (see anchor())
+    long long ty;
+
+    Placement(int px = 0, int py = 0, float s = 1.0f)
+        : x(px), y(py), scale(s), orientation(ORIENT_R0), affine(false), r_scale(FIXED_ONE),
+          tx(0), ty(0) {
+        m[0] = m[3] = FIXED_ONE;
+        m[1] = m[2] = 0;
+    }
+
+    // Linear part a b / c d (already including scale)
+    void set_matrix(double a, double b, double c, double d) {
+        affine = true;
+        m[0] = to_fixed(a);
+        m[1] = to_fixed(b);
+        m[2] = to_fixed(c);
+        m[3] = to_fixed(d);
+        r_scale = to_fixed(sqrt(fabs(a * d - b * c)));
+    }
+
+    // Clockwise rotation by an arbitrary angle (degrees); see anchor()
+    void set_rotation(double degrees) {
+        double rad = degrees * M_PI / 180.0;
+        double c = cos(rad) * scale;
+        double s = sin(rad) * scale;
+        set_matrix(c, -s, s, c);
+    }
+
+    void map(int lx, int ly, int& ox, int& oy) const {
+        if (affine) {
+            long long fx = (long long)m[0] * lx + (long long)m[1] * ly + tx;
+            long long fy = (long long)m[2] * lx + (long long)m[3] * ly + ty;
+            ox = (int)((fx + FIXED_ONE / 2) >> FIXED_SHIFT) + x;
+            oy = (int)((fy + FIXED_ONE / 2) >> FIXED_SHIFT) + y;
+        } else {
+            ox = (int)(lx * scale) + x;
+            oy = (int)(ly * scale) + y;
+        }
+    }
+
+    // Offset m[] so the transformed box b keeps its top left corner where
+    // scale alone puts it, like the precomputed variants do
+    void anchor(const StrokeBounds& b) {
+        long long w = b.x1 - b.x0, h = b.y1 - b.y0;
+        long long min_x = 0, min_y = 0;
+        long long corners[3][2] = {{w, 0}, {0, h}, {w, h}};
+        for (int k = 0; k < 3; k++) {
+            long long cx = m[0] * corners[k][0] + m[1] * corners[k][1];
+            long long cy = m[2] * corners[k][0] + m[3] * corners[k][1];
+            if (cx < min_x) min_x = cx;
+            if (cy < min_y) min_y = cy;
+        }
+        tx = (long long)(int)(b.x0 * scale) * FIXED_ONE - ((long long)m[0] * b.x0 + (long long)m[1] * b.y0) - min_x;
+        ty = (long long)(int)(b.y0 * scale) * FIXED_ONE - ((long long)m[2] * b.x0 + (long long)m[3] * b.y0) - min_y;
+    }
+
+    int tr(int r) const {
+        if (affine) return (int)(((long long)r_scale * r + FIXED_ONE / 2) >> FIXED_SHIFT);
+        return (int)(r * scale);
+    }
+
+    // Library pixels -> display pixels, used to pick a level of detail
+    float effective_scale() const {
+        if (affine) return (float)r_scale / FIXED_ONE;
+        return scale < 0 ? -scale : scale;
+    }
+
+    // Coarsest level whose error stays within LOD_MAX_ERROR_PX on screen.
+    // stride is the distance between consecutive levels in the array.
+    int select_lod(const DetailLevel* levels, int stride = 1) const {
+        float s = effective_scale();
+        for (int lod = LOD_COUNT - 1; lod > 0; lod--) {
+            if (levels[lod * stride].error * s <= LOD_MAX_ERROR_PX) return lod;
+        }
+        return 0;
+    }
+
+    // Same, for the per-level errors stored in a library file
+    int select_lod(const float* errors) const {
+        float s = effective_scale();
+        for (int lod = LOD_COUNT - 1; lod > 0; lod--) {
+            if (errors[lod] * s <= LOD_MAX_ERROR_PX) return lod;
+        }
+        return 0;
+    }
+};
+
+// Linear part of each orientation variant, in ORIENT_* order
+static const int ORIENT_MATRIX[ORIENT_COUNT][4] = {
+    { 1,  0,  0,  1}, { 0, -1,  1,  0}, {-1,  0,  0, -1}, { 0,  1, -1,  0},
+    {-1,  0,  0,  1}, { 0, -1, -1,  0}, { 1,  0,  0, -1}, { 0,  1,  1,  0}
+};
+
+// Orientation variant that matrix a b / c d draws at scale k, or -1
+inline int matrix_orientation(double a, double b, double c, double d, double& k) {
+    k = fabs(a) + fabs(b);
+    if (k <= 0) return -1;
+    for (int i = 0; i < ORIENT_COUNT; i++) {
+        const int* o = ORIENT_MATRIX[i];
+        if (a == o[0] * k && b == o[1] * k && c == o[2] * k && d == o[3] * k) return i;
+    }
+    return -1;
+}
+
+// Whether matrix a b / c d only rotates, mirrors and scales uniformly: its
+// columns are orthogonal and equally long, so a circle stays a circle
+inline bool is_similarity(double a, double b, double c, double d) {
+    double ca = a * a + c * c, cb = b * b + d * d;
+    double tol = 1e-3 * (ca + cb);
+    return ca > 0 && fabs(ca - cb) <= tol && fabs(a * b + c * d) <= tol;
+}
+
+// Whether s holds nothing but white space
+inline bool is_blank(const char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    return *s == '\0';
+}
+
+// Parse a transform token ("rot90", "mirror", "rot37", "matrix") into p.
+// For "matrix", the four coefficients are read from rest and rest_used is
+// set past them; otherwise it is 0.
+// Returns false if the token is not a valid transform.
+inline bool parse_transform(const char* token, const char* rest, Placement& p, int& rest_used) {
+    rest_used = 0;
+    static const char* const names[ORIENT_COUNT] = {
+        "rot0", "rot90", "rot180", "rot270",
+        "mirror", "mirror90", "mirror180", "mirror270"
+    };
+    for (int i = 0; i < ORIENT_COUNT; i++) {
+        if (strcmp(token, names[i]) == 0) {
+            p.orientation = i;
+            return true;
+        }
+    }
+
+    if (strncmp(token, "rot", 3) == 0) {
+        char* end;
+        double deg = strtod(token + 3, &end);
+        if (end == token + 3 || *end != '\0') return false;
+        if (fmod(deg, 90.0) == 0) {
+            p.orientation = (int)(((long long)(deg / 90.0) % 4 + 4) % 4);
+        } else {
+            p.set_rotation(deg);
+        }
+        return true;
+    }
+
+    if (strcmp(token, "matrix") == 0) {
+        double a, b, c, d, k;
+        int used = 0;
+        if (sscanf(rest, "%lf %lf %lf %lf%n", &a, &b, &c, &d, &used) != 4 || used == 0) return false;
+        if (!is_similarity(a, b, c, d)) return false;
+        rest_used = used;
+        int orientation = matrix_orientation(a, b, c, d, k);
+        if (orientation >= 0) {
+            p.orientation = orientation;
+            p.scale *= k;
+        } else {
+            p.set_matrix(a * p.scale, b * p.scale, c * p.scale, d * p.scale);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+// Transform one decoded command and hand it to the sink
+inline void emit_op(StrokeSink& sink, const StrokeOp& op, const Placement& p) {
+    int ox, oy;
+    char cmd[80];
+
+    switch (op.op) {
+        case OP_DOWN:
+            p.map(op.a, op.b, ox, oy);
+            sink.down(ox, oy);
+            break;
+        case OP_MOVE:
+            p.map(op.a, op.b, ox, oy);
+            sink.move(ox, oy);
+            break;
+        case OP_UP:
+            sink.up();
+            break;
+        case OP_CIRCLE:
+            p.map(op.a, op.b, ox, oy);
+            sink.circle(ox, oy, p.tr(op.c), p.tr(op.d));
+            break;
+        case OP_LINE:
+        case OP_RECTANGLE:
+            snprintf(cmd, sizeof(cmd), "pen %s %d %d %d %d",
+                     op.op == OP_LINE ? "line" : "rectangle", op.a, op.b, op.c, op.d);
+            sink.raw(cmd);
+            break;
+        default:
+            break;
+    }
+}
+
+// Decode up to count packed commands, transforming and emitting each one
+// as it is decoded
+inline void render_strokes(StrokeSink& sink, const uint8_t* data, size_t size, int count,
+                           const Placement& p) {
+    StrokeDecoder decoder(data, size);
+    StrokeOp op;
+    for (int i = 0; i < count && decoder.next(op); i++) {
+        emit_op(sink, op, p);
+    }
+}
+
+// Orientation variant to draw for a placement
+inline int placement_orientation(const Placement& p) {
+    if (!p.affine && p.orientation > ORIENT_R0 && p.orientation < ORIENT_COUNT) {
+        return p.orientation;
+    }
+    return ORIENT_R0;
+}
+
+// Draw one level/orientation of a library file entry
+inline void render_entry(StrokeSink& sink, const LibraryFile& file, const LibraryEntry& entry,
+                         int orientation, const Placement& p) {
+    const LibraryVariant& v = entry.variants[p.select_lod(entry.error)][orientation];
+    size_t avail = 0;
+    const uint8_t* data = file.get_strokes(v, avail);
+    if (!data) return;
+    if (!p.affine) {
+        render_strokes(sink, data, avail, (int)v.count, p);
+        return;
+    }
+
+    // Affine fallback: anchor on the full detail R0 box the variants use
+    const LibraryVariant& full = entry.variants[0][ORIENT_R0];
+    size_t full_avail = 0;
+    const uint8_t* full_data = file.get_strokes(full, full_avail);
+    if (!full_data) return;
+    Placement q = p;
+    q.anchor(stroke_bounds(full_data, full_avail, (int)full.count));
+    render_strokes(sink, data, avail, (int)v.count, q);
+}
+
+// Level and orientation a placement of comp draws; its events and draw_us
+// are what the placement will cost lamp
+inline const DetailLevel& placement_level(const Component& comp, const Placement& p) {
+    int lod = p.select_lod(&comp.levels[0][0], ORIENT_COUNT);
+    return comp.levels[lod][placement_orientation(p)];
+}
+
+// Draw a component from the embedded library
+inline void render_component(StrokeSink& sink, const Component& comp, const Placement& p) {
+    const DetailLevel& level = placement_level(comp, p);
+    if (!p.affine) {
+        render_strokes(sink, level.data, level.size, level.count, p);
+        return;
+    }
+
+    const DetailLevel& full = comp.levels[0][ORIENT_R0];
+    Placement q = p;
+    q.anchor(stroke_bounds(full.data, full.size, full.count));
+    render_strokes(sink, level.data, level.size, level.count, q);
+}
+
+// Draw a component by name: library files first, then the embedded library.
+// Returns false if no library has it.
+inline bool render_component(StrokeSink& sink, const char* name, const Placement& p) {
+    const LibraryFile* file = NULL;
+    const LibraryEntry* entry = library().find(LIBRARY_COMPONENT, name, &file);
+    if (entry) {
+        render_entry(sink, *file, *entry, placement_orientation(p), p);
+        return true;
+    }
+
+    const Component* comp = find_component(name);
+    if (!comp) return false;
+    render_component(sink, *comp, p);
+    return true;
+}
+
+// Draw a string using font glyphs, advancing GLYPH_ADVANCE * scale per char.
+// Returns the number of characters that had no glyph.
+inline int render_text(StrokeSink& sink, int x, int y, const char* text, float scale) {
+    int missing = 0;
+    int advance = (int)(GLYPH_ADVANCE * scale);
+    Placement p(x, y, scale);
+
+    for (const char* c = text; *c; c++) {
+        char ch = toupper((unsigned char)*c);
+        if (ch != ' ') {
+            const LibraryFile* file = NULL;
+            const LibraryEntry* entry = library().find_glyph(ch, &file);
+            const FontGlyph* glyph = entry ? NULL : find_glyph(ch);
+            if (entry) {
+                render_entry(sink, *file, *entry, ORIENT_R0, p);
+            } else if (glyph) {
+                const DetailLevel& level = glyph->levels[p.select_lod(glyph->levels)];
+                render_strokes(sink, level.data, level.size, level.count, p);
+            } else {
+                missing++;
+            }
+        }
+        p.x += advance;
+    }
+
+    return missing;
+}
+
+// Result of handle_request()
+enum RequestStatus {
+    REQUEST_NONE,      // Line is not a placement request
+    REQUEST_OK,        // Request rendered
+    REQUEST_ERROR      // Placement request that could not be rendered
+};
+
+// Parse and render one placement request line.
+// On REQUEST_ERROR a short reason is written to err.
+inline RequestStatus handle_request(StrokeSink& sink, const char* line,
+                                    char* err = NULL, size_t err_len = 0) {
+    char verb[16];
+    int consumed = 0;
+    if (sscanf(line, " %15s%n", verb, &consumed) != 1) return REQUEST_NONE;
+    const char* args = line + consumed;
+
+    if (strcmp(verb, "place") == 0) {
+        char name[64];
+        int x, y;
+        float scale = 1.0f;
+        int used = 0;
+        if (sscanf(args, " %63s %d %d%n", name, &x, &y, &used) < 3) {
+            if (err) snprintf(err, err_len, "usage: place <name> <x> <y> [scale] [transform]");
+            return REQUEST_ERROR;
+        }
+        args += used;
+
+        // Optional scale, then optional transform
+        int scale_used = 0;
+        if (sscanf(args, " %f%n", &scale, &scale_used) == 1) args += scale_used;
+
+        Placement p(x, y, scale);
+        char token[32];
+        int token_used = 0;
+        if (sscanf(args, " %31s%n", token, &token_used) == 1) {
+            int rest_used = 0;
+            args += token_used;
+            if (!parse_transform(token, args, p, rest_used)) {
+                if (err && strcmp(token, "matrix") == 0) {
+                    snprintf(err, err_len, "usage: matrix <a> <b> <c> <d> (rotation, mirror, uniform scale)");
+                } else if (err) {
+                    snprintf(err, err_len, "unknown transform '%s'", token);
+                }
+                return REQUEST_ERROR;
+            }
+            args += rest_used;
+            if (!is_blank(args)) {
+                if (err) snprintf(err, err_len, "unexpected '%s' after transform", args + strspn(args, " \t"));
+                return REQUEST_ERROR;
+            }
+        }
+
+        if (!render_component(sink, name, p)) {
+            if (err) snprintf(err, err_len, "component '%s' not found", name);
+            return REQUEST_ERROR;
+        }
+        return REQUEST_OK;
+    }
+
+    if (strcmp(verb, "text") == 0) {
+        int x, y;
+        float scale;
+        int text_at = 0;
+        if (sscanf(args, " %d %d %f %n", &x, &y, &scale, &text_at) < 3 || text_at == 0) {
+            if (err) snprintf(err, err_len, "usage: text <x> <y> <scale> <string>");
+            return REQUEST_ERROR;
+        }
+
+        render_text(sink, x, y, args + text_at, scale);
+        return REQUEST_OK;
+    }
+
+    return REQUEST_NONE;
+}
+
+}  // namespace elxnk
+
+#endif  // ELXNK_RENDERER_H
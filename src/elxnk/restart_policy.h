@@ -0,0 +1,143 @@
+// Restart Policy - crash-loop handling for elxnk's children
+//
+// Every child has its own policy. An exit after the child ran at least
+// stable_after is a one-off and restarted at once. Exits in a row after
+// shorter runs back off exponentially: restart_delay, doubling per exit up
+// to restart_max_delay, each spread by +/- restart_jitter percent so
+// children failing together do not restart in lockstep.
+//
+// Restarts are also budgeted: at most restart_budget in any restart_window.
+// A child over budget is degraded: left down, and tried again after
+// degraded_retry with a fresh budget (never, if that is 0).
+//
+// The limits come from the [Process] section of elxnk.conf, in seconds
+// (fractions allowed); set() takes one key=value from it.
+
+#ifndef ELXNK_RESTART_POLICY_H
+#define ELXNK_RESTART_POLICY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace elxnk {
+
+// Restart limits, in milliseconds
+struct RestartLimits {
+    long long delay_ms;             // Backoff after the second exit in a row
+    long long max_delay_ms;         // Backoff cap
+    int jitter_pct;                 // Backoff spread, +/- percent
+    long long stable_ms;            // A run this long ends a crash streak
+    int budget;                     // Restarts allowed per window
+    long long window_ms;
+    long long degraded_retry_ms;    // Degraded children tried again after, 0 never
+    long long shutdown_ms;          // SIGTERM to SIGKILL on shutdown
+
+    RestartLimits()
+        : delay_ms(1000), max_delay_ms(60000), jitter_pct(20), stable_ms(10000), budget(5), window_ms(60000),
+          degraded_retry_ms(300000), shutdown_ms(3000) {}
+
+    // Applies key=value if key is a [Process] setting
+    bool set(const std::string& key, const std::string& value) {
+        long long* field = key == "restart_delay" ? &delay_ms
+                         : key == "restart_max_delay" ? &max_delay_ms
+                         : key == "stable_after" ? &stable_ms
+                         : key == "restart_window" ? &window_ms
+                         : key == "degraded_retry" ? &degraded_retry_ms
+                         : key == "shutdown_timeout" ? &shutdown_ms
+                         : NULL;
+        double v = atof(value.c_str());
+        if (v < 0) v = 0;
+        if (field) {
+            *field = (long long)(v * 1000);
+        } else if (key == "restart_jitter") {
+            jitter_pct = v > 100 ? 100 : (int)v;
+        } else if (key == "restart_budget") {
+            budget = (int)v;
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+class RestartPolicy {
+private:
+    std::vector<long long> recent;      // Restarts within the window
+    unsigned int seed;
+
+    long long backoff(const RestartLimits& limits) {
+        if (streak <= 1) return 0;
+        long long delay = limits.delay_ms;
+        for (int i = 2; i < streak && delay < limits.max_delay_ms; i++) delay *= 2;
+        if (delay > limits.max_delay_ms) delay = limits.max_delay_ms;
+        if (limits.jitter_pct > 0 && delay > 0) {
+            int pct = rand_r(&seed) % (2 * limits.jitter_pct + 1) - limits.jitter_pct;
+            delay += delay * pct / 100;
+        }
+        return delay;
+    }
+
+public:
+    // Counters
+    unsigned long starts;
+    unsigned long exits;                // Including failed starts
+    unsigned long restarts;             // Scheduled
+    unsigned long degradations;
+    int streak;                         // Exits in a row without a stable run
+    long long last_delay_ms;
+    bool degraded;
+
+    explicit RestartPolicy(unsigned int random_seed = 1)
+        : seed(random_seed), starts(0), exits(0), restarts(0), degradations(0), streak(0), last_delay_ms(0),
+          degraded(false) {}
+
+    void reseed(unsigned int random_seed) {
+        seed = random_seed;
+    }
+
+    void started() {
+        starts++;
+        degraded = false;
+    }
+
+    // The child exited, or failed to start, at now after running uptime_ms:
+    // milliseconds until it is started again, -1 for never. degraded tells
+    // whether the budget ran out.
+    long long exited(const RestartLimits& limits, long long now, long long uptime_ms) {
+        exits++;
+        if (uptime_ms >= limits.stable_ms) streak = 0;
+        streak++;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < recent.size(); i++) {
+            if (now - recent[i] < limits.window_ms) recent[kept++] = recent[i];
+        }
+        recent.resize(kept);
+
+        if ((int)recent.size() >= limits.budget) {
+            degraded = true;
+            degradations++;
+            recent.clear();
+            streak = 0;
+            last_delay_ms = limits.degraded_retry_ms > 0 ? limits.degraded_retry_ms : -1;
+            return last_delay_ms;
+        }
+        last_delay_ms = backoff(limits);
+        recent.push_back(now + last_delay_ms);
+        restarts++;
+        return last_delay_ms;
+    }
+
+    // Restarts counting against the budget at now
+    int in_window(const RestartLimits& limits, long long now) const {
+        int n = 0;
+        for (size_t i = 0; i < recent.size(); i++) n += now - recent[i] < limits.window_ms;
+        return n;
+    }
+};
+
+}  // namespace elxnk
+
+#endif  // ELXNK_RESTART_POLICY_H
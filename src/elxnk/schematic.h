@@ -0,0 +1,285 @@
+// Schematic Renderer - whole-circuit batch rendering
+// Turns a placement file into one optimized stroke stream for lamp
+//
+// SCHEMATIC FORMAT (one item per line, '#' starts a comment):
+//   place <name> <x> <y> [scale] [transform]  - Component (same as renderer.h)
+//   wire <x1> <y1> <x2> <y2> [<x3> <y3> ...]  - Wire polyline
+//   dot <x> <y> [r]                           - Junction dot (default r=4)
+//   label <x> <y> <scale> <string...>         - Text label ("text" also accepted)
+//
+// Items are read in windows of SCHEMATIC_WINDOW. Within a window, wires that
+// share endpoints are joined into one stroke and all items are drawn in
+// nearest-neighbor order from the current pen position, which carries over
+// between windows. Memory stays bounded by the window size however large the
+// schematic is, and each window is streamed to the sink as soon as it is ordered.
+
+#ifndef ELXNK_SCHEMATIC_H
+#define ELXNK_SCHEMATIC_H
+
+#include <vector>
+#include <string>
+#include "renderer.h"
+
+namespace elxnk {
+
+// Items ordered together before they are streamed out
+#define SCHEMATIC_WINDOW 64
+
+// Points per wire line
+#define SCHEMATIC_MAX_WIRE_POINTS 64
+
+// Default junction dot radius (pixels)
+#define SCHEMATIC_DOT_RADIUS 4
+
+enum SchematicItemType { ITEM_PLACE, ITEM_WIRE, ITEM_DOT, ITEM_LABEL };
+
+struct SchematicItem {
+    SchematicItemType type;
+    std::string request;        // place/label: renderer request line
+    std::vector<int> points;    // wire: x0 y0 x1 y1 ...; place/dot/label: x y [r]
+    bool done;                  // Drawn, or wire joined into another one
+
+    SchematicItem() : type(ITEM_PLACE), done(false) {}
+
+    int start_x() const { return points[0]; }
+    int start_y() const { return points[1]; }
+    int end_x() const { return points[points.size() - 2]; }
+    int end_y() const { return points[points.size() - 1]; }
+
+    void reverse_wire() {
+        std::vector<int> r;
+        r.reserve(points.size());
+        for (size_t i = points.size(); i >= 2; i -= 2) {
+            r.push_back(points[i - 2]);
+            r.push_back(points[i - 1]);
+        }
+        points.swap(r);
+    }
+};
+
+// Counters reported after a batch
+struct SchematicStats {
+    int lines;
+    int placements;
+    int wires;
+    int wires_merged;
+    int dots;
+    int labels;
+    int errors;
+    long travel;    // Pen-up travel distance (pixels, Manhattan)
+
+    SchematicStats() : lines(0), placements(0), wires(0), wires_merged(0),
+                       dots(0), labels(0), errors(0), travel(0) {}
+};
+
+class SchematicRenderer {
+private:
+    StrokeSink& sink;
+    std::vector<SchematicItem> window;
+    int pen_x, pen_y;
+    SchematicStats stats;
+
+    static int distance(int ax, int ay, int bx, int by) {
+        return abs(ax - bx) + abs(ay - by);
+    }
+
+    // Join wires whose endpoints coincide into longer polylines
+    void merge_wires() {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = 0; i < window.size(); i++) {
+                SchematicItem& a = window[i];
+                if (a.type != ITEM_WIRE || a.done) continue;
+
+                for (size_t j = 0; j < window.size(); j++) {
+                    SchematicItem& b = window[j];
+                    if (i == j || b.type != ITEM_WIRE || b.done) continue;
+
+                    // Orient b so that it starts where a ends
+                    if (b.start_x() == a.end_x() && b.start_y() == a.end_y()) {
+                        // already aligned
+                    } else if (b.end_x() == a.end_x() && b.end_y() == a.end_y()) {
+                        b.reverse_wire();
+                    } else if (b.end_x() == a.start_x() && b.end_y() == a.start_y()) {
+                        a.reverse_wire();
+                        b.reverse_wire();
+                    } else if (b.start_x() == a.start_x() && b.start_y() == a.start_y()) {
+                        a.reverse_wire();
+                    } else {
+                        continue;
+                    }
+
+                    a.points.insert(a.points.end(), b.points.begin() + 2, b.points.end());
+                    b.done = true;
+                    stats.wires_merged++;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    void draw(SchematicItem& item) {
+        char err[128];
+
+        switch (item.type) {
+            case ITEM_WIRE:
+                sink.down(item.points[0], item.points[1]);
+                for (size_t i = 2; i + 1 < item.points.size(); i += 2) {
+                    sink.move(item.points[i], item.points[i + 1]);
+                }
+                sink.up();
+                pen_x = item.end_x();
+                pen_y = item.end_y();
+                return;
+
+            case ITEM_DOT:
+                sink.circle(item.points[0], item.points[1], item.points[2], item.points[2]);
+                break;
+
+            case ITEM_PLACE:
+            case ITEM_LABEL:
+                if (handle_request(sink, item.request.c_str(), err, sizeof(err)) != REQUEST_OK) {
+                    fprintf(stderr, "Schematic: %s\n", err);
+                    stats.errors++;
+                }
+                break;
+        }
+
+        pen_x = item.points[0];
+        pen_y = item.points[1];
+    }
+
+    // Draw the window in nearest-neighbor order from the current pen position
+    void flush_window() {
+        merge_wires();
+
+        for (;;) {
+            int best = -1;
+            int best_dist = 0;
+            bool best_reversed = false;
+
+            for (size_t i = 0; i < window.size(); i++) {
+                SchematicItem& item = window[i];
+                if (item.done) continue;
+
+                int d = distance(pen_x, pen_y, item.start_x(), item.start_y());
+                bool reversed = false;
+                if (item.type == ITEM_WIRE) {
+                    int dr = distance(pen_x, pen_y, item.end_x(), item.end_y());
+                    if (dr < d) {
+                        d = dr;
+                        reversed = true;
+                    }
+                }
+
+                if (best < 0 || d < best_dist) {
+                    best = (int)i;
+                    best_dist = d;
+                    best_reversed = reversed;
+                }
+            }
+
+            if (best < 0) break;
+
+            SchematicItem& item = window[best];
+            if (best_reversed) item.reverse_wire();
+            stats.travel += best_dist;
+            draw(item);
+            item.done = true;
+        }
+
+        window.clear();
+    }
+
+    bool parse_line(const char* line, SchematicItem& item) {
+        char verb[16];
+        int used = 0;
+        if (sscanf(line, " %15s%n", verb, &used) != 1) return false;
+        const char* args = line + used;
+        int x, y;
+
+        if (strcmp(verb, "place") == 0) {
+            char name[64];
+            if (sscanf(args, " %63s %d %d", name, &x, &y) != 3) return false;
+            item.type = ITEM_PLACE;
+            item.request = line;
+            item.points.push_back(x);
+            item.points.push_back(y);
+            stats.placements++;
+            return true;
+        }
+
+        if (strcmp(verb, "label") == 0 || strcmp(verb, "text") == 0) {
+            if (sscanf(args, " %d %d", &x, &y) != 2) return false;
+            item.type = ITEM_LABEL;
+            item.request = std::string("text") + args;
+            item.points.push_back(x);
+            item.points.push_back(y);
+            stats.labels++;
+            return true;
+        }
+
+        if (strcmp(verb, "dot") == 0) {
+            int r = SCHEMATIC_DOT_RADIUS;
+            if (sscanf(args, " %d %d %d", &x, &y, &r) < 2) return false;
+            item.type = ITEM_DOT;
+            item.points.push_back(x);
+            item.points.push_back(y);
+            item.points.push_back(r);
+            stats.dots++;
+            return true;
+        }
+
+        if (strcmp(verb, "wire") == 0) {
+            item.type = ITEM_WIRE;
+            int n = 0;
+            while (item.points.size() < 2 * SCHEMATIC_MAX_WIRE_POINTS &&
+                   sscanf(args, " %d %d%n", &x, &y, &n) == 2) {
+                item.points.push_back(x);
+                item.points.push_back(y);
+                args += n;
+            }
+            if (item.points.size() < 4) return false;
+            stats.wires++;
+            return true;
+        }
+
+        return false;
+    }
+
+public:
+    explicit SchematicRenderer(StrokeSink& out) : sink(out), pen_x(0), pen_y(0) {
+        window.reserve(SCHEMATIC_WINDOW);
+    }
+
+    // Add one line of the schematic; draws a window whenever it fills up
+    bool add_line(const char* line) {
+        stats.lines++;
+        while (*line == ' ' || *line == '\t') line++;
+        if (*line == '\0' || *line == '#') return true;
+
+        SchematicItem item;
+        if (!parse_line(line, item)) {
+            stats.errors++;
+            return false;
+        }
+
+        window.push_back(item);
+        if (window.size() >= SCHEMATIC_WINDOW) flush_window();
+        return true;
+    }
+
+    // Draw whatever is left
+    void finish() {
+        flush_window();
+    }
+
+    const SchematicStats& get_stats() const {
+        return stats;
+    }
+};
+
+}  // namespace elxnk
+
+#endif  // ELXNK_SCHEMATIC_H
@@ -0,0 +1,167 @@
+// Stroke Codec - packed stroke commands
+// Shared by the embedded library, library files and svgc
+//
+// ENCODING: each command is one header byte followed by its operands
+//   header: low nibble = OpCode, high nibble = 0 (reserved)
+//   OP_DOWN, OP_MOVE       dx dy          - Delta from the current point
+//   OP_UP                  -
+//   OP_CIRCLE              dx dy r1 r2    - Center delta, then radii
+//   OP_LINE, OP_RECTANGLE  x1 y1 x2 y2    - Absolute (sent untransformed)
+//
+// Deltas and coordinates are zig-zag encoded, radii are unsigned; all are
+// varints (7 bits per byte, low bits first, high bit set on all but the last
+// byte). The current point starts at (0, 0) and follows every down, move and
+// circle center. A typical pen move takes 3 bytes, against a pointer plus
+// about 16 bytes of text for the "pen move X Y" string form.
+//
+// StrokeDecoder walks a stream one command at a time with no allocation,
+// so the renderer transforms and emits each command as it is decoded.
+
+#ifndef ELXNK_STROKE_CODEC_H
+#define ELXNK_STROKE_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace elxnk {
+
+// Stroke opcodes (lamp pen commands)
+enum OpCode {
+    OP_END = 0,
+    OP_DOWN,        // a b = x y
+    OP_MOVE,        // a b = x y
+    OP_UP,
+    OP_CIRCLE,      // a b c d = cx cy r1 r2
+    OP_LINE,        // a b c d = x1 y1 x2 y2 (sent untransformed)
+    OP_RECTANGLE    // a b c d = x1 y1 x2 y2 (sent untransformed)
+};
+
+// One decoded command, in absolute library coordinates
+struct StrokeOp {
+    int op;
+    int a, b, c, d;
+};
+
+inline uint32_t zigzag_encode(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t zigzag_decode(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Streaming decoder over one packed command stream
+class StrokeDecoder {
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    int x, y;
+
+    bool varint(uint32_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (p >= end) return false;
+            uint8_t byte = *p++;
+            v |= (uint32_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool svarint(int& v) {
+        uint32_t u;
+        if (!varint(u)) return false;
+        v = zigzag_decode(u);
+        return true;
+    }
+
+public:
+    // data must stay valid while decoding; size bounds every read
+    StrokeDecoder(const uint8_t* data, size_t size) : p(data), end(data + size), x(0), y(0) {}
+
+    // Decode the next command. Returns false at the end of the data or on
+    // a malformed command.
+    bool next(StrokeOp& op) {
+        if (p >= end) return false;
+        op.op = *p++ & 0x0f;
+        op.c = op.d = 0;
+
+        uint32_t r1, r2;
+        switch (op.op) {
+            case OP_DOWN:
+            case OP_MOVE:
+            case OP_CIRCLE:
+                if (!svarint(op.a) || !svarint(op.b)) return false;
+                x += op.a;
+                y += op.b;
+                op.a = x;
+                op.b = y;
+                if (op.op != OP_CIRCLE) return true;
+                if (!varint(r1) || !varint(r2)) return false;
+                op.c = (int)r1;
+                op.d = (int)r2;
+                return true;
+            case OP_UP:
+                op.a = op.b = 0;
+                return true;
+            case OP_LINE:
+            case OP_RECTANGLE:
+                return svarint(op.a) && svarint(op.b) && svarint(op.c) && svarint(op.d);
+            default:
+                return false;
+        }
+    }
+};
+
+// Appends packed commands to a byte vector (build time)
+class StrokeEncoder {
+private:
+    std::vector<uint8_t>& out;
+    int x, y;
+
+    void varint(uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((uint8_t)v);
+    }
+
+    void svarint(int v) {
+        varint(zigzag_encode(v));
+    }
+
+    void point(int op, int px, int py) {
+        out.push_back((uint8_t)op);
+        svarint(px - x);
+        svarint(py - y);
+        x = px;
+        y = py;
+    }
+
+public:
+    explicit StrokeEncoder(std::vector<uint8_t>& bytes) : out(bytes), x(0), y(0) {}
+
+    void down(int px, int py) { point(OP_DOWN, px, py); }
+    void move(int px, int py) { point(OP_MOVE, px, py); }
+    void up() { out.push_back((uint8_t)OP_UP); }
+
+    void circle(int cx, int cy, int r1, int r2) {
+        point(OP_CIRCLE, cx, cy);
+        varint((uint32_t)r1);
+        varint((uint32_t)r2);
+    }
+
+    void raw(int op, int a, int b, int c, int d) {
+        out.push_back((uint8_t)op);
+        svarint(a);
+        svarint(b);
+        svarint(c);
+        svarint(d);
+    }
+};
+
+}  // namespace elxnk
+
+#endif  // ELXNK_STROKE_CODEC_H
@@ -0,0 +1,59 @@
+#!/bin/bash
+# Elxnk client library for scripts
+# Sends placement requests to lamp over a single persistent pipe descriptor.
+#
+# Usage (source it, then call the functions):
+#   . /opt/bin/elxnk_client.sh
+#   elxnk_open
+#   elxnk_place R 500 500 1.0
+#   elxnk_text 100 100 0.4 "HELLO"
+#   elxnk_pen down 100 100
+#   elxnk_close
+#
+# All functions are bash builtins only (printf/redirect), so a placement costs
+# one write() to the pipe - no render_component or lamp process per call.
+
+ELXNK_PIPE="${ELXNK_PIPE:-/tmp/elxnk_lamp.pipe}"
+ELXNK_FD=""
+
+# Open the lamp pipe once for all following requests
+elxnk_open() {
+    [ -n "$ELXNK_FD" ] && return 0
+
+    if [ ! -p "$ELXNK_PIPE" ]; then
+        echo "elxnk: lamp pipe not found at $ELXNK_PIPE (is elxnk running?)" >&2
+        return 1
+    fi
+
+    exec {ELXNK_FD}>"$ELXNK_PIPE"
+}
+
+# Close the pipe descriptor
+elxnk_close() {
+    [ -z "$ELXNK_FD" ] && return 0
+    exec {ELXNK_FD}>&-
+    ELXNK_FD=""
+}
+
+# Send one raw lamp line (opens the pipe on first use)
+elxnk_send() {
+    [ -z "$ELXNK_FD" ] && { elxnk_open || return 1; }
+    printf '%s\n' "$*" >&"$ELXNK_FD"
+}
+
+# elxnk_place <name> <x> <y> [scale]
+elxnk_place() {
+    elxnk_send "place $1 $2 $3 ${4:-1.0}"
+}
+
+# elxnk_text <x> <y> <scale> <string...>
+elxnk_text() {
+    local x="$1" y="$2" scale="$3"
+    shift 3
+    elxnk_send "text $x $y $scale $*"
+}
+
+# elxnk_pen <down|move|up|line|circle|...> [args...]
+elxnk_pen() {
+    elxnk_send "pen $*"
+}
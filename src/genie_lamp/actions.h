@@ -0,0 +1,535 @@
+// Actions - what a recognized gesture does
+//
+// Built-in actions run in process and draw by writing lamp commands to the
+// lamp pipe elxnk creates (/tmp/elxnk_lamp.pipe, or $ELXNK_PIPE), kept open
+// across gestures, each redraw sent in a single write():
+//   action=draw <lamp line>[; <lamp line>...]   Send lamp commands as given
+//   action=redraw                               Redraw the component list UI
+//   action=page next|prev                       Change list page and redraw
+//   action=item next|prev                       Move the selection and redraw
+//   action=select                               Toggle the selected preview
+// The list UI is the one ui_state.sh draws, over the components of the
+// embedded library (asset_metadata.h). Its page, selection and mode are
+// shared with ui_state.sh through /tmp/genie_ui/state.txt.
+//
+// command=... runs an external program with posix_spawn. Commands without
+// shell syntax are executed directly; anything with quotes, pipes,
+// redirects, && and the like goes through /bin/sh -c. At most
+// MAX_RUNNING_COMMANDS run at once; further ones wait in a FIFO (up to
+// MAX_PENDING_COMMANDS) and start as running ones are reaped, which the
+// worker checks every 500 ms while it has children. It never waits on them.
+//
+// Actions run on a worker thread (ActionQueue), so the input thread only
+// recognizes gestures and never waits on lamp, a child or the disk. Actions
+// recognized while the worker is busy are taken together: a draw or redraw
+// already waiting is not queued again (commands always are, since what one
+// does is unknown), and list changes are all applied before the list is
+// drawn once, so three quick "page next" taps turn three pages with a
+// single redraw. A full queue drops the action.
+// Each queued action holds a reference to its gesture table, so a config
+// reload does not free it under the worker.
+//
+// Every gesture carries a GestureTrace from recognition on. The worker
+// times its stages (elxnk/latency.h) and sends the trace to lamp ahead of
+// the commands drawn for it; a batched redraw carries its oldest gesture.
+
+#ifndef GENIE_ACTIONS_H
+#define GENIE_ACTIONS_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gesture_table.h"
+#include "../elxnk/asset_metadata.h"
+#include "../elxnk/latency.h"
+
+extern char** environ;
+
+#define LAMP_PIPE "/tmp/elxnk_lamp.pipe"
+#define UI_STATE_DIR "/tmp/genie_ui"
+#define UI_STATE_FILE UI_STATE_DIR "/state.txt"
+#define MAX_QUEUED_ACTIONS 16
+#define MAX_RUNNING_COMMANDS 2
+#define MAX_PENDING_COMMANDS 16
+
+// List UI layout, as in ui_state.sh
+#define UI_X 1000               // Left edge of UI box
+#define UI_Y 1400               // Top edge of UI box
+#define UI_WIDTH 404
+#define UI_HEIGHT 472
+#define ITEMS_PER_PAGE 5
+#define UI_TEXT_SCALE "0.4"
+#define UI_COMPONENT_SCALE "0.8"
+
+// One recognized gesture on its way to the screen
+struct GestureTrace {
+    unsigned id;
+    long long event_us;         // Input event (or deadline) that fired it
+    long long recognized_us;
+    long long queued_us;
+};
+
+// genie_lamp's stages of the gesture-to-ink latency
+struct ActionLatency {
+    elxnk::LatencyHistogram recognize;
+    elxnk::LatencyHistogram dispatch;
+    elxnk::LatencyHistogram queue;
+    elxnk::LatencyHistogram generate;
+
+    ActionLatency() : recognize("recognize"), dispatch("dispatch"), queue("queue"), generate("generate") {}
+
+    void print(FILE* out) const {
+        recognize.print(out);
+        dispatch.print(out);
+        queue.print(out);
+        generate.print(out);
+    }
+};
+
+// Persistent write end of the lamp pipe, reopened when lamp restarts
+class LampConnection {
+private:
+    std::string path;
+    int fd;
+
+public:
+    LampConnection() : fd(-1) {
+        const char* env = getenv("ELXNK_PIPE");
+        path = env && *env ? env : LAMP_PIPE;
+    }
+
+    ~LampConnection() {
+        close_pipe();
+    }
+
+    // Non-blocking open fails at once when no lamp is reading; writes then
+    // block as usual so a redraw is never cut short
+    bool open_pipe() {
+        if (fd >= 0) return true;
+        fd = open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            fprintf(stderr, "Lamp pipe %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        return true;
+    }
+
+    void close_pipe() {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+    // Send newline-terminated lamp commands; one retry on a fresh descriptor
+    // if lamp went away since the last write (SIGPIPE is ignored)
+    bool send(const std::string& commands) {
+        for (int attempt = 0; attempt < 2; attempt++) {
+            if (!open_pipe()) return false;
+            size_t done = 0;
+            while (done < commands.size()) {
+                ssize_t n = write(fd, commands.data() + done, commands.size() - done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                done += n;
+            }
+            if (done == commands.size()) return true;
+            close_pipe();
+            if (done > 0) return false;     // Partly sent; do not repeat strokes
+        }
+        return false;
+    }
+
+    // Same, preceded by the trace line lamp times its first write from
+    bool send(const std::string& commands, const GestureTrace& trace) {
+        char line[80];
+        snprintf(line, sizeof(line), "trace %u %lld %lld\n", trace.id, trace.event_us, elxnk::monotonic_us());
+        return send(line + commands);
+    }
+};
+
+// Page, selection and preview mode of the list UI
+class ListUi {
+private:
+    int page;
+    int selected;
+    bool preview;
+
+    int total() const { return elxnk::COMPONENT_INFO_COUNT; }
+    int total_pages() const { return (total() + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE; }
+
+    // Keep the selection on the current page
+    void clamp_selection() {
+        int start = page * ITEMS_PER_PAGE;
+        int end = start + ITEMS_PER_PAGE - 1;
+        if (end >= total()) end = total() - 1;
+        if (selected < start) selected = start;
+        if (selected > end) selected = end;
+    }
+
+    __attribute__((format(printf, 2, 3))) static void line(std::string& out, const char* format, ...) {
+        char buf[160];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        out += buf;
+        out += '\n';
+    }
+
+    static void box(std::string& out) {
+        line(out, "pen down %d %d", UI_X, UI_Y);
+        line(out, "pen move %d %d", UI_X + UI_WIDTH, UI_Y);
+        line(out, "pen move %d %d", UI_X + UI_WIDTH, UI_Y + UI_HEIGHT);
+        line(out, "pen move %d %d", UI_X, UI_Y + UI_HEIGHT);
+        line(out, "pen move %d %d", UI_X, UI_Y);
+        line(out, "pen up");
+    }
+
+public:
+    ListUi() : page(0), selected(0), preview(false) {}
+
+    // Picks up where ui_state.sh left off, if it ran
+    void load() {
+        FILE* f = fopen(UI_STATE_FILE, "r");
+        if (!f) return;
+        char buf[64];
+        while (fgets(buf, sizeof(buf), f)) {
+            if (strncmp(buf, "page=", 5) == 0) page = atoi(buf + 5);
+            else if (strncmp(buf, "selected=", 9) == 0) selected = atoi(buf + 9);
+            else if (strncmp(buf, "mode=", 5) == 0) preview = strncmp(buf + 5, "preview", 7) == 0;
+        }
+        fclose(f);
+        if (page < 0 || page >= total_pages()) page = 0;
+        clamp_selection();
+    }
+
+    void save() const {
+        mkdir(UI_STATE_DIR, 0755);
+        FILE* f = fopen(UI_STATE_FILE, "w");
+        if (!f) return;
+        fprintf(f, "page=%d\nselected=%d\nmode=%s\n", page, selected, preview ? "preview" : "list");
+        fclose(f);
+    }
+
+    void next_page() {
+        if (page + 1 < total_pages()) page++;
+        clamp_selection();
+    }
+
+    void prev_page() {
+        if (page > 0) page--;
+        clamp_selection();
+    }
+
+    void next_item() {
+        if (selected + 1 < total()) selected++;
+        if (selected >= (page + 1) * ITEMS_PER_PAGE) next_page();
+    }
+
+    void prev_item() {
+        if (selected > 0) selected--;
+        if (selected < page * ITEMS_PER_PAGE) prev_page();
+    }
+
+    void toggle_preview() {
+        preview = !preview;
+    }
+
+    // Lamp commands for the whole UI: clear, border, list, preview
+    std::string draw() const {
+        std::string out;
+        line(out, "erase on");
+        box(out);
+        line(out, "erase off");
+        box(out);
+
+        line(out, "text %d %d 0.3 PG %d %d", UI_X + 10, UI_Y + 10, page + 1, total_pages());
+        int y = UI_Y + 50;
+        for (int i = 0; i < ITEMS_PER_PAGE; i++) {
+            int index = page * ITEMS_PER_PAGE + i;
+            if (index >= total()) break;
+            if (index == selected) line(out, "pen line %d %d %d %d", UI_X + 4, y + 8, UI_X + 8, y + 8);
+            line(out, "text %d %d " UI_TEXT_SCALE " %d %s", UI_X + 10, y, index + 1,
+                 elxnk::COMPONENT_INFO[index].name);
+            y += 60;
+        }
+
+        if (preview && selected < total()) {
+            line(out, "place %s %d %d " UI_COMPONENT_SCALE, elxnk::COMPONENT_INFO[selected].name,
+                 UI_X + UI_WIDTH / 2 - 50, UI_Y + 250);
+        }
+        return out;
+    }
+};
+
+// True if cmd needs a shell to mean what it says
+inline bool needs_shell(const std::string& cmd) {
+    return cmd.find_first_of("|&;<>()$`\\\"'*?[]#~={}\n") != std::string::npos;
+}
+
+class ActionRunner {
+private:
+    LampConnection lamp;
+    ListUi ui;
+    int running;                // Spawned commands not reaped yet
+    std::deque<std::string> pending;        // Waiting for a running one to exit
+
+    // Runs cmd now, or once fewer than MAX_RUNNING_COMMANDS are running
+    void spawn(const std::string& cmd) {
+        if (running < MAX_RUNNING_COMMANDS) {
+            start(cmd);
+        } else if (pending.size() < MAX_PENDING_COMMANDS) {
+            pending.push_back(cmd);
+        } else {
+            fprintf(stderr, "Warning: Too many commands waiting, '%s' dropped\n", cmd.c_str());
+        }
+    }
+
+    void start(const std::string& cmd) {
+        std::vector<std::string> words;
+        if (needs_shell(cmd)) {
+            words.push_back("/bin/sh");
+            words.push_back("-c");
+            words.push_back(cmd);
+        } else {
+            size_t pos = 0;
+            while ((pos = cmd.find_first_not_of(" \t", pos)) != std::string::npos) {
+                size_t end = cmd.find_first_of(" \t", pos);
+                words.push_back(cmd.substr(pos, end - pos));
+                pos = end;
+            }
+        }
+        if (words.empty()) return;
+
+        std::vector<char*> argv;
+        for (size_t i = 0; i < words.size(); i++) argv.push_back(&words[i][0]);
+        argv.push_back(NULL);
+
+        pid_t pid;
+        int err = posix_spawnp(&pid, argv[0], NULL, NULL, &argv[0], environ);
+        if (err != 0) {
+            fprintf(stderr, "Warning: Cannot run %s: %s\n", argv[0], strerror(err));
+            return;
+        }
+        running++;
+    }
+
+    // Reap one exited command without waiting. False if none.
+    bool reap() {
+        if (running == 0) return false;
+        pid_t pid;
+        while ((pid = waitpid(-1, NULL, WNOHANG)) < 0 && errno == EINTR) {}
+        if (pid < 0) running = 0;       // ECHILD: nothing left to wait for
+        if (pid <= 0) return false;
+        running--;
+        return true;
+    }
+
+public:
+    ActionRunner() : running(0) {}
+
+    // SIGPIPE ignored turns a vanished lamp into a write error
+    void init() {
+        signal(SIGPIPE, SIG_IGN);
+        ui.load();
+    }
+
+    // Runs a batch of actions in order, picked up from the queue at
+    // picked_us; the list is drawn once at the end if any of them changed it
+    void run(const GestureConfig* const* batch, const GestureTrace* traces, int count, long long picked_us,
+             elxnk::LatencyHistogram& generate) {
+        int redraw = -1;        // First gesture that changed the list
+        for (int i = 0; i < count; i++) {
+            const GestureConfig& g = *batch[i];
+            switch (g.action) {
+                case ACTION_COMMAND:
+                    printf("Running: %s\n", g.command.c_str());
+                    spawn(g.command);
+                    generate.add(elxnk::monotonic_us() - picked_us);
+                    continue;
+                case ACTION_DRAW:
+                    generate.add(elxnk::monotonic_us() - picked_us);
+                    lamp.send(g.argument, traces[i]);
+                    continue;
+                case ACTION_PAGE_NEXT: ui.next_page(); break;
+                case ACTION_PAGE_PREV: ui.prev_page(); break;
+                case ACTION_ITEM_NEXT: ui.next_item(); break;
+                case ACTION_ITEM_PREV: ui.prev_item(); break;
+                case ACTION_SELECT: ui.toggle_preview(); break;
+                case ACTION_REDRAW: break;
+            }
+            if (redraw < 0) redraw = i;
+        }
+        if (redraw >= 0) {
+            std::string commands = ui.draw();
+            generate.add(elxnk::monotonic_us() - picked_us);
+            lamp.send(commands, traces[redraw]);
+            ui.save();
+        }
+        fflush(stdout);
+    }
+
+    // Reap whatever exited since and start waiting commands in their
+    // place; true while commands are still running
+    bool reap_exited() {
+        while (reap()) {}
+        while (running < MAX_RUNNING_COMMANDS && !pending.empty()) {
+            start(pending.front());
+            pending.pop_front();
+        }
+        return running > 0;
+    }
+};
+
+// Hands recognized gestures to a worker thread that runs their actions.
+// push() is called from the input thread and only takes a short lock.
+class ActionQueue {
+private:
+    struct Queued {
+        const GestureConfig* gesture;
+        std::shared_ptr<const GestureTable> table;      // Keeps gesture alive
+        GestureTrace trace;
+    };
+
+    ActionRunner runner;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::thread worker;
+    bool stopping;
+
+    Queued queue[MAX_QUEUED_ACTIONS];       // Ring, oldest at head
+    int head;
+    int count;
+
+    // Counters, under lock
+    unsigned long queued;
+    unsigned long coalesced;
+    unsigned long dropped;
+    unsigned long batches;
+
+    // Same result whether it runs once or twice in a row. An external
+    // command may count or toggle something, so it is never assumed to be.
+    static bool idempotent(ActionKind action) {
+        return action == ACTION_DRAW || action == ACTION_REDRAW;
+    }
+
+    void work() {
+        Queued batch[MAX_QUEUED_ACTIONS];
+        const GestureConfig* gestures[MAX_QUEUED_ACTIONS];
+        GestureTrace traces[MAX_QUEUED_ACTIONS];
+        bool children = false;
+        std::unique_lock<std::mutex> guard(lock);
+        while (!stopping) {
+            if (count == 0) {
+                // Exited commands are reaped now and then while idle
+                if (children) {
+                    wake.wait_for(guard, std::chrono::milliseconds(500));
+                } else {
+                    wake.wait(guard);
+                }
+            }
+            int n = count;
+            long long picked_us = elxnk::monotonic_us();
+            for (int i = 0; i < n; i++) {
+                Queued& q = queue[(head + i) % MAX_QUEUED_ACTIONS];
+                batch[i].gesture = q.gesture;
+                batch[i].table.swap(q.table);
+                gestures[i] = batch[i].gesture;
+                traces[i] = q.trace;
+                latency.queue.add(picked_us - q.trace.queued_us);
+            }
+            head = (head + n) % MAX_QUEUED_ACTIONS;
+            count = 0;
+            if (n > 0) batches++;
+
+            guard.unlock();
+            if (n > 0) runner.run(gestures, traces, n, picked_us, latency.generate);
+            for (int i = 0; i < n; i++) batch[i].table.reset();
+            children = runner.reap_exited();
+            guard.lock();
+        }
+    }
+
+public:
+    ActionLatency latency;
+
+    ActionQueue()
+        : stopping(false), head(0), count(0), queued(0), coalesced(0), dropped(0), batches(0) {}
+
+    ~ActionQueue() {
+        stop();
+    }
+
+    void start() {
+        runner.init();
+        worker = std::thread(&ActionQueue::work, this);
+    }
+
+    // Drops whatever is still queued
+    void stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    // Queue the action of a recognized gesture from table; never blocks on
+    // the worker. Fills in trace.queued_us.
+    void push(const GestureConfig& g, const std::shared_ptr<const GestureTable>& table, GestureTrace trace) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (idempotent(g.action)) {
+                for (int i = 0; i < count; i++) {
+                    if (queue[(head + i) % MAX_QUEUED_ACTIONS].gesture == &g) {
+                        coalesced++;
+                        return;
+                    }
+                }
+            }
+            if (count == MAX_QUEUED_ACTIONS) {
+                dropped++;
+                fprintf(stderr, "Warning: Action queue full, '%s' dropped\n", g.command.c_str());
+                return;
+            }
+            Queued& q = queue[(head + count) % MAX_QUEUED_ACTIONS];
+            q.gesture = &g;
+            q.table = table;
+            q.trace = trace;
+            q.trace.queued_us = elxnk::monotonic_us();
+            latency.dispatch.add(q.trace.queued_us - trace.recognized_us);
+            count++;
+            queued++;
+        }
+        wake.notify_one();
+    }
+
+    void print_stats() {
+        std::lock_guard<std::mutex> guard(lock);
+        printf("Actions: %lu queued in %lu batches, %lu coalesced, %lu dropped\n", queued, batches,
+               coalesced, dropped);
+        printf("Latency (lamp dumps first write and total on \"latency\"):\n");
+        latency.print(stdout);
+        fflush(stdout);
+    }
+};
+
+#endif  // GENIE_ACTIONS_H
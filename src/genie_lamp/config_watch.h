@@ -0,0 +1,140 @@
+// Config Watch - live reload of the gesture config for genie_lamp
+//
+// The config's directory is watched with inotify, since editors and scp
+// often replace the file rather than write it in place. When the file is
+// written or moved into place, a loader thread parses it into a fresh
+// GestureTable; the input loop never parses. The loader signals an eventfd
+// when the table is ready and the loop takes it with take(), then puts it
+// in once the detector is idle (see gesture_detector.h). Changes made while
+// a load runs start one more load after it.
+//
+// A config that fails to open or has no gestures is reported and the
+// current table kept, so a half-finished edit does not disable gestures.
+
+#ifndef GENIE_CONFIG_WATCH_H
+#define GENIE_CONFIG_WATCH_H
+
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "gesture_table.h"
+
+class ConfigWatch {
+private:
+    std::string path;
+    std::string name;                   // File name within the watched directory
+    int inotify_fd;
+    int event_fd;                       // Loader done
+
+    std::thread loader;
+    std::mutex lock;
+    std::shared_ptr<const GestureTable> loaded;     // Built, not taken yet
+    bool loading;
+    bool again;                         // Changed during the load
+
+    void load() {
+        for (;;) {
+            std::shared_ptr<GestureTable> table = std::make_shared<GestureTable>();
+            bool ok = table->load(path.c_str());
+            if (ok && table->size() == 0) {
+                fprintf(stderr, "Warning: %s has no gestures, keeping the current ones\n", path.c_str());
+                ok = false;
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (ok) loaded = table;
+            if (!again) {
+                loading = false;
+                break;
+            }
+            again = false;
+        }
+        uint64_t one = 1;
+        if (write(event_fd, &one, sizeof(one)) < 0) perror("eventfd");
+    }
+
+    void start_load() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (loading) {
+            again = true;
+            return;
+        }
+        if (loader.joinable()) loader.join();       // Finished, or nearly
+        loading = true;
+        loader = std::thread(&ConfigWatch::load, this);
+    }
+
+public:
+    ConfigWatch() : inotify_fd(-1), event_fd(-1), loading(false), again(false) {}
+
+    ~ConfigWatch() {
+        if (loader.joinable()) loader.join();
+        if (inotify_fd >= 0) close(inotify_fd);
+        if (event_fd >= 0) close(event_fd);
+    }
+
+    // Start watching config_file. Without it, the config is just not
+    // reloaded.
+    bool open(const char* config_file) {
+        path = config_file;
+        size_t slash = path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (event_fd < 0 || inotify_fd < 0 ||
+            inotify_add_watch(inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            perror("Config watch (reload disabled)");
+            return false;
+        }
+        return true;
+    }
+
+    // Descriptors for the caller's wait: changes, and a table ready
+    int change_fd() const {
+        return inotify_fd;
+    }
+
+    int ready_fd() const {
+        return event_fd;
+    }
+
+    // change_fd() is readable: start a load if it was our file
+    void handle_change() {
+        char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        bool changed = false;
+        ssize_t n;
+        while ((n = read(inotify_fd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + n;) {
+                const struct inotify_event* ie = (const struct inotify_event*)p;
+                p += sizeof(struct inotify_event) + ie->len;
+                if (ie->len && name == ie->name) changed = true;
+            }
+        }
+        if (changed) {
+            printf("Config changed, reloading %s\n", path.c_str());
+            start_load();
+        }
+    }
+
+    // ready_fd() is readable: the new table, or NULL if the load failed
+    std::shared_ptr<const GestureTable> take() {
+        uint64_t count;
+        while (read(event_fd, &count, sizeof(count)) < 0 && errno == EINTR) {}
+        std::lock_guard<std::mutex> guard(lock);
+        std::shared_ptr<const GestureTable> table;
+        table.swap(loaded);
+        return table;
+    }
+};
+
+#endif  // GENIE_CONFIG_WATCH_H
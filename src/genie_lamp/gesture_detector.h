@@ -0,0 +1,499 @@
+// Gesture Detector - multitouch tracking and gesture recognition for genie_lamp
+//
+// Touches are tracked per multitouch slot (protocol B) in a fixed array, with
+// a bitmask of the active slots; the finger count is its population count.
+// The device's ABS_MT_SLOT range sets how many slots are used (at most
+// MAX_SLOTS), events for slots beyond it are ignored.
+//
+// Each touch device (up to MAX_TOUCH_DEVICES, numbered by the caller) has
+// its own slots and frame state, so a second touch screen, such as lamp's
+// virtual one, neither interleaves with the first nor masks its slots.
+// Recognition counts and measures the fingers of all of them together, as
+// of each one's last completed frame.
+//
+// RECOGNITION: everything from the first finger down to the last one up is
+// one touch sequence, and fires at most one gesture. Timing comes from the
+// kernel's event timestamps, so it does not depend on the report rate:
+//   swipe       - the fingers' center travels swipe_px; fires right away,
+//                 direction from the dominant axis
+//   pinch       - the fingers' spread changes by pinch_px (2+ fingers)
+//   long press  - held long_press_ms without moving more than tap_move_px,
+//                 where one is configured; elsewhere a hold can still
+//                 turn into a swipe or pinch
+//   tap         - lifted within tap_ms without moving; counts the most
+//                 fingers that were down
+//   double tap  - a second tap with as many fingers within double_tap_ms.
+//                 Only where one is configured does a tap wait that long
+//                 for it; elsewhere taps fire on lift.
+// Counts change as fingers land and lift; swipe and pinch are measured from
+// where the fingers were when the count last changed. The sequence's region
+// (gesture_table.h) is looked up as fingers land, from the center of where
+// they landed; a double tap needs both taps in the same region.
+//
+// Long presses and held taps fire when their time runs out, which can be
+// between events: timeout_ms() gives the caller's wait the next deadline and
+// tick() settles it, so nothing polls. During fire(), cause_us() tells what
+// fired the gesture: the event's timestamp, or the deadline that passed.
+//
+// SYN_DROPPED means the kernel buffer overflowed and events were lost: the
+// rest of that frame is ignored and resync_pending() asks the caller to read
+// the slots back from the device (EVIOCGMTSLOTS) and pass them to resync().
+// A touch sequence in progress then fires nothing more.
+//
+// Positions are screen pixels (the rM2 touch Y axis runs bottom to top).
+// The stylus only reports whether the pen touches the screen; a sequence
+// during which it does is a hand resting while writing and fires nothing.
+// The caller leaves out the strokes lamp draws itself.
+// After load_config() nothing allocates.
+//
+// The gesture table is shared, so a new one (a reloaded config) can be put
+// in with set_table() while actions queued from the old one still run. Swap
+// it only while idle(), so no touch sequence is judged by two configs.
+
+#ifndef GENIE_GESTURE_DETECTOR_H
+#define GENIE_GESTURE_DETECTOR_H
+
+#include <linux/input.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include "gesture_table.h"
+
+#define MAX_SLOTS 32            // Bits in the active-slot mask
+#define MAX_TOUCH_DEVICES 4     // Touch devices tracked; events of others are ignored
+
+struct TouchPoint {
+    int tracking_id;
+    int x;
+    int y;
+    int start_x;                // Where it landed
+    int start_y;
+};
+
+// Slot and frame state of one touch device
+struct TouchSlots {
+    TouchPoint touches[MAX_SLOTS];
+    uint32_t active;                        // Bit per slot with a touch down
+    uint32_t landed;                        // Slots touched down this frame
+    uint32_t down;                          // active as of the last SYN_REPORT
+    int slot_count;                         // Slots in use, from ABS_MT_SLOT
+    int current_slot;
+    bool dropping;                          // Events lost, skipping to SYN_REPORT
+    bool resync_wanted;                     // Waiting for resync()
+
+    void reset() {
+        memset(touches, 0, sizeof(touches));
+        active = 0;
+        landed = 0;
+        down = 0;
+        slot_count = MAX_SLOTS;
+        current_slot = 0;
+        dropping = false;
+        resync_wanted = false;
+    }
+};
+
+inline long long event_us(const struct input_event& ev) {
+    return (long long)ev.time.tv_sec * 1000000 + ev.time.tv_usec;
+}
+
+class SimpleGestureDetector {
+private:
+    TouchSlots screens[MAX_TOUCH_DEVICES];
+    int screen_count;                       // Highest device number seen + 1
+    bool pen_touching;                      // Stylus on the screen
+
+    // Current touch sequence
+    bool touching;
+    bool spent;                             // Fired or ruled out, waiting for lift
+    bool moved;                             // A finger left tap_move_px
+    long long start_us;
+    int max_fingers;
+    int base_fingers;                       // Count the baseline was taken at
+    int base_x, base_y;                     // Center of the fingers then
+    float base_spread;                      // Their mean distance from it
+    int region;                             // Where the fingers landed
+
+    // Tap held back for a possible double tap
+    bool tap_pending;
+    int tap_fingers;
+    int tap_region;
+    long long tap_end_us;
+
+    std::shared_ptr<const GestureTable> table;
+    long long cause_time;                   // See cause_us()
+
+    // Center and mean distance from it of the fingers down
+    void measure(int& cx, int& cy, float& spread) const {
+        int n = 0;
+        long sx = 0, sy = 0;
+        for (int d = 0; d < screen_count; d++) {
+            for (uint32_t m = screens[d].down; m; m &= m - 1) {
+                const TouchPoint& t = screens[d].touches[__builtin_ctz(m)];
+                sx += t.x;
+                sy += t.y;
+                n++;
+            }
+        }
+        cx = n ? sx / n : 0;
+        cy = n ? sy / n : 0;
+        float sum = 0;
+        for (int d = 0; d < screen_count; d++) {
+            for (uint32_t m = screens[d].down; m; m &= m - 1) {
+                const TouchPoint& t = screens[d].touches[__builtin_ctz(m)];
+                sum += hypotf(t.x - cx, t.y - cy);
+            }
+        }
+        spread = n ? sum / n : 0;
+    }
+
+    // Region of the center of where the fingers down landed
+    int landing_region() const {
+        int n = 0;
+        long sx = 0, sy = 0;
+        for (int d = 0; d < screen_count; d++) {
+            for (uint32_t m = screens[d].down; m; m &= m - 1) {
+                const TouchPoint& t = screens[d].touches[__builtin_ctz(m)];
+                sx += t.start_x;
+                sy += t.start_y;
+                n++;
+            }
+        }
+        return n ? table->region_at(sx / n, sy / n) : 0;
+    }
+
+    bool any_moved(int limit) const {
+        for (int d = 0; d < screen_count; d++) {
+            for (uint32_t m = screens[d].down; m; m &= m - 1) {
+                const TouchPoint& t = screens[d].touches[__builtin_ctz(m)];
+                int dx = t.x - t.start_x, dy = t.y - t.start_y;
+                if (dx * dx + dy * dy > limit * limit) return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether touch device number device can be tracked; counts it in
+    bool has_screen(int device) {
+        if ((unsigned)device < (unsigned)screen_count) return true;
+        if ((unsigned)device >= MAX_TOUCH_DEVICES) return false;
+        screen_count = device + 1;
+        return true;
+    }
+
+    // Fingers down on all touch devices
+    int finger_count() const {
+        int n = 0;
+        for (int d = 0; d < screen_count; d++) n += __builtin_popcount(screens[d].down);
+        return n;
+    }
+
+    void dispatch(GestureKind kind, int fingers, int where) {
+        const GestureConfig* g = table->lookup(kind, fingers, where);
+        if (g) fire(*g, fingers);
+    }
+
+    void flush_tap() {
+        if (!tap_pending) return;
+        tap_pending = false;
+        dispatch(GESTURE_TAP, tap_fingers, tap_region);
+    }
+
+    // Recognized: fire it if configured, and wait for all fingers to lift
+    void recognize(GestureKind kind, int fingers) {
+        flush_tap();
+        dispatch(kind, fingers, region);
+        spent = true;
+    }
+
+    void tap(int fingers, long long now) {
+        const GestureThresholds& limits = table->thresholds();
+        if (tap_pending && tap_fingers == fingers && tap_region == region &&
+            start_us - tap_end_us <= limits.double_tap_ms * 1000LL) {
+            tap_pending = false;
+            dispatch(GESTURE_DOUBLE_TAP, fingers, region);
+            return;
+        }
+        flush_tap();
+        if (table->has(GESTURE_DOUBLE_TAP, fingers, region)) {
+            tap_pending = true;
+            tap_fingers = fingers;
+            tap_region = region;
+            tap_end_us = now;
+        } else {
+            dispatch(GESTURE_TAP, fingers, region);
+        }
+    }
+
+    // Once per frame while fingers are down
+    void track(int fingers, long long now) {
+        const GestureThresholds& limits = table->thresholds();
+
+        if (!touching) {
+            touching = true;
+            spent = false;
+            moved = false;
+            start_us = now;
+            max_fingers = 0;
+            base_fingers = 0;
+            if (tap_pending && now - tap_end_us >= limits.double_tap_ms * 1000LL) flush_tap();
+        }
+        if (fingers > max_fingers) {
+            max_fingers = fingers;
+            region = landing_region();
+        }
+        if (fingers != base_fingers) {
+            base_fingers = fingers;
+            measure(base_x, base_y, base_spread);
+        }
+        if (pen_touching) spent = true;
+        if (spent) return;
+
+        if (!moved) moved = any_moved(limits.tap_move_px);
+
+        int cx, cy;
+        float spread;
+        measure(cx, cy, spread);
+        int dx = cx - base_x, dy = cy - base_y;
+        float travel = hypotf(dx, dy);
+        float pinch = spread - base_spread;
+
+        if (fingers >= 2 && fabsf(pinch) >= limits.pinch_px && fabsf(pinch) > travel) {
+            recognize(pinch < 0 ? GESTURE_PINCH_IN : GESTURE_PINCH_OUT, fingers);
+        } else if (travel >= limits.swipe_px) {
+            GestureKind kind = abs(dx) >= abs(dy) ? (dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT)
+                                                  : (dy < 0 ? GESTURE_SWIPE_UP : GESTURE_SWIPE_DOWN);
+            recognize(kind, fingers);
+        } else {
+            check_long_press(now);
+        }
+    }
+
+    // A hold only counts where a long press is configured; elsewhere the
+    // touch stays open for swipes and pinches
+    bool long_press_possible() const {
+        return touching && !spent && !moved && table->has(GESTURE_LONG_PRESS, max_fingers, region);
+    }
+
+    void check_long_press(long long now) {
+        if (long_press_possible() && now - start_us >= table->thresholds().long_press_ms * 1000LL) {
+            recognize(GESTURE_LONG_PRESS, max_fingers);
+        }
+    }
+
+    // All fingers lifted
+    void release(long long now) {
+        touching = false;
+        if (pen_touching) spent = true;
+        if (!spent && !moved && now - start_us <= table->thresholds().tap_ms * 1000LL) {
+            tap(max_fingers, now);
+        } else {
+            flush_tap();
+        }
+    }
+
+public:
+    SimpleGestureDetector()
+        : screen_count(1), pen_touching(false),
+          touching(false), spent(false), moved(false), start_us(0), max_fingers(0), base_fingers(0),
+          base_x(0), base_y(0), base_spread(0), region(0), tap_pending(false), tap_fingers(0), tap_region(0),
+          tap_end_us(0),
+          table(std::make_shared<GestureTable>()), cause_time(0) {
+        for (int d = 0; d < MAX_TOUCH_DEVICES; d++) screens[d].reset();
+    }
+
+    virtual ~SimpleGestureDetector() {}
+
+    // Slots a touch device reports (ABS_MT_SLOT maximum + 1)
+    void set_slot_count(int slots, int device = 0) {
+        if (!has_screen(device)) return;
+        TouchSlots& s = screens[device];
+        if (slots > MAX_SLOTS) slots = MAX_SLOTS;
+        if (slots < 1) slots = 1;
+        if (slots == s.slot_count) return;
+        s.slot_count = slots;
+        if (slots < MAX_SLOTS) {
+            s.active &= (1u << slots) - 1;
+            s.down &= (1u << slots) - 1;
+        }
+    }
+
+    // A touch device went away: its fingers count as lifted, and the number
+    // is free for the next one. A sequence it was part of fires nothing more.
+    void remove_device(int device, long long now) {
+        if ((unsigned)device >= MAX_TOUCH_DEVICES) return;
+        bool had = screens[device].down != 0;
+        screens[device].reset();
+        if (had && touching) {
+            spent = true;
+            detect_gestures(now);
+        }
+    }
+
+    void load_config(const char* config_file) {
+        std::shared_ptr<GestureTable> loaded = std::make_shared<GestureTable>();
+        loaded->load(config_file);
+        table = loaded;
+    }
+
+    const std::shared_ptr<const GestureTable>& current_table() const {
+        return table;
+    }
+
+    void set_table(const std::shared_ptr<const GestureTable>& next) {
+        table = next;
+    }
+
+    // No touch sequence or held tap in progress
+    bool idle() const {
+        return !touching && !tap_pending;
+    }
+
+    // Events from touch device number device
+    void process_event(const struct input_event& ev, int device = 0) {
+        if (!has_screen(device)) return;
+        TouchSlots& s = screens[device];
+        if (ev.type == EV_ABS) {
+            if (s.dropping) return;
+            if (ev.code == ABS_MT_SLOT) {
+                s.current_slot = ev.value;
+                return;
+            }
+            if ((unsigned)s.current_slot >= (unsigned)s.slot_count) return;
+
+            TouchPoint& t = s.touches[s.current_slot];
+            switch (ev.code) {
+                case ABS_MT_TRACKING_ID:
+                    t.tracking_id = ev.value;
+                    if (ev.value == -1) {
+                        s.active &= ~(1u << s.current_slot);    // Touch lifted
+                    } else {
+                        s.active |= 1u << s.current_slot;       // New touch
+                        s.landed |= 1u << s.current_slot;
+                    }
+                    break;
+
+                case ABS_MT_POSITION_X:
+                    t.x = ev.value;
+                    break;
+
+                case ABS_MT_POSITION_Y:
+                    t.y = SCREEN_HEIGHT - ev.value;
+                    break;
+            }
+        } else if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+            s.dropping = true;
+        } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+            if (s.dropping) {
+                s.dropping = false;
+                s.resync_wanted = true;
+                s.landed = 0;
+                return;
+            }
+            // End of event frame: new touches start where they are now
+            for (uint32_t m = s.landed & s.active; m; m &= m - 1) {
+                TouchPoint& t = s.touches[__builtin_ctz(m)];
+                t.start_x = t.x;
+                t.start_y = t.y;
+            }
+            s.landed = 0;
+            s.down = s.active;
+            detect_gestures(event_us(ev));
+        }
+    }
+
+    bool resync_pending(int device = 0) const {
+        return (unsigned)device < MAX_TOUCH_DEVICES && screens[device].resync_wanted;
+    }
+
+    // State of the device's first slot_count slots as read from it after
+    // events were lost: tracking IDs (-1 for none), raw positions, and the
+    // slot later events refer to
+    void resync(const int32_t* ids, const int32_t* xs, const int32_t* ys, int slot, long long now,
+                int device = 0) {
+        if (!has_screen(device)) return;
+        TouchSlots& s = screens[device];
+        s.resync_wanted = false;
+        uint32_t was = s.active;
+        s.active = 0;
+        for (int i = 0; i < s.slot_count; i++) {
+            TouchPoint& t = s.touches[i];
+            bool same = (was & (1u << i)) && t.tracking_id == ids[i];
+            t.tracking_id = ids[i];
+            t.x = xs[i];
+            t.y = SCREEN_HEIGHT - ys[i];
+            if (ids[i] < 0) continue;
+            s.active |= 1u << i;
+            if (!same) {
+                t.start_x = t.x;
+                t.start_y = t.y;
+            }
+        }
+        s.current_slot = slot;
+        s.down = s.active;
+        if (touching) spent = true;     // What it did in the gap is unknown
+        detect_gestures(now);
+    }
+
+    // Events from a stylus device: only whether the pen touches the screen
+    void process_pen_event(const struct input_event& ev) {
+        if (ev.type == EV_KEY && ev.code == BTN_TOUCH) {
+            pen_touching = ev.value != 0;
+        }
+    }
+
+    void detect_gestures(long long now) {
+        cause_time = now;
+        int fingers = finger_count();
+        if (fingers > 0) {
+            track(fingers, now);
+        } else if (touching) {
+            release(now);
+        }
+    }
+
+    // Milliseconds until a long press or held tap is due, -1 if none.
+    // now is on the clock of the event timestamps.
+    int timeout_ms(long long now) const {
+        const GestureThresholds& limits = table->thresholds();
+        long long due = -1;
+        if (long_press_possible()) due = start_us + limits.long_press_ms * 1000LL;
+        if (tap_pending) {
+            long long tap_due = tap_end_us + limits.double_tap_ms * 1000LL;
+            if (due < 0 || tap_due < due) due = tap_due;
+        }
+        if (due < 0) return -1;
+        return due <= now ? 0 : (int)((due - now + 999) / 1000);
+    }
+
+    // Settle whatever timeout_ms() was waiting for
+    void tick(long long now) {
+        const GestureThresholds& limits = table->thresholds();
+        cause_time = start_us + limits.long_press_ms * 1000LL;
+        check_long_press(now);
+        cause_time = tap_end_us + limits.double_tap_ms * 1000LL;
+        if (tap_pending && now - tap_end_us >= limits.double_tap_ms * 1000LL) flush_tap();
+    }
+
+    // Event timestamp or deadline behind the gesture being fired
+    long long cause_us() const {
+        return cause_time;
+    }
+
+    // A gesture matched and is configured: act on it
+    virtual void fire(const GestureConfig& g, int finger_count) = 0;
+
+    int get_gesture_count() const {
+        return table->size();
+    }
+
+    const std::vector<GestureConfig>& get_gestures() const {
+        return table->configured();
+    }
+};
+
+#endif  // GENIE_GESTURE_DETECTOR_H
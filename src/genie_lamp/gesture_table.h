@@ -0,0 +1,425 @@
+// Gesture Table - configured gestures compiled for lookup
+//
+// The config is parsed once and compiled into a flat table indexed by
+// (gesture kind, finger count, region), each entry the gesture to fire or
+// none. Matching a frame is one array lookup however many gestures are
+// configured; gesture names are compared only while loading.
+//
+// Swipe and pinch directions are part of the kind, so "swipe left" and
+// "swipe right" are separate entries.
+//
+// REGIONS: region 0 is the whole screen; up to GESTURE_REGIONS - 1 named
+// rectangles can be defined, and a gesture bound to one fires only for
+// touches there. A touch is in the first named region holding the center of
+// where its fingers landed, else in region 0. Gestures of region 0 apply in
+// every region that does not configure its own, which is resolved when the
+// table is compiled, so the lookup stays one array access. Finding the
+// region goes through a grid of REGION_CELL pixel cells, each with a mask of
+// the regions overlapping it, so at most those few rectangles are tested.
+//
+// CONFIG: blocks of key=value lines separated by blank lines, # comments
+//   gesture=swipe           tap, doubletap, longpress, swipe or pinch
+//   direction=left          swipe: left, right, up, down; pinch: in, out
+//   fingers=2
+//   region=ui               optional, a named region
+//   action=page next        built-in action (actions.h), or
+//   command=...             external command
+// When several blocks map to the same entry the first one wins, as it did
+// when the list was scanned in order.
+//
+// Regions are defined on lines of their own anywhere in the file, in screen
+// pixels: region.<name>=<x> <y> <width> <height>
+//
+// Recognizer thresholds (gesture_detector.h) can be set on lines of their
+// own anywhere in the file, e.g. swipe_px=200; see GestureThresholds.
+
+#ifndef GENIE_GESTURE_TABLE_H
+#define GENIE_GESTURE_TABLE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <fstream>
+#include <vector>
+
+#define MAX_FINGERS 10
+#define SCREEN_WIDTH 1404
+#define SCREEN_HEIGHT 1872
+#define GESTURE_REGIONS 8       // Bits in a grid cell's mask
+#define REGION_CELL 64          // Grid cell size, pixels
+#define REGION_COLS ((SCREEN_WIDTH + REGION_CELL - 1) / REGION_CELL)
+#define REGION_ROWS ((SCREEN_HEIGHT + REGION_CELL - 1) / REGION_CELL)
+
+enum GestureKind {
+    GESTURE_TAP,
+    GESTURE_DOUBLE_TAP,
+    GESTURE_LONG_PRESS,
+    GESTURE_SWIPE_LEFT,
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_SWIPE_UP,
+    GESTURE_SWIPE_DOWN,
+    GESTURE_PINCH_IN,
+    GESTURE_PINCH_OUT,
+    GESTURE_KINDS
+};
+
+struct GestureKindName {
+    const char* gesture;        // Config names
+    const char* direction;
+    const char* label;          // For messages
+};
+
+static const GestureKindName GESTURE_KIND_NAMES[GESTURE_KINDS] = {
+    { "tap", "", "tap" },
+    { "doubletap", "", "double tap" },
+    { "longpress", "", "long press" },
+    { "swipe", "left", "swipe left" },
+    { "swipe", "right", "swipe right" },
+    { "swipe", "up", "swipe up" },
+    { "swipe", "down", "swipe down" },
+    { "pinch", "in", "pinch in" },
+    { "pinch", "out", "pinch out" },
+};
+
+inline const char* gesture_kind_name(GestureKind kind) {
+    return kind < GESTURE_KINDS ? GESTURE_KIND_NAMES[kind].label : "unknown";
+}
+
+inline bool parse_gesture_kind(const std::string& gesture, const std::string& direction, GestureKind& kind) {
+    for (int k = 0; k < GESTURE_KINDS; k++) {
+        if (gesture == GESTURE_KIND_NAMES[k].gesture && direction == GESTURE_KIND_NAMES[k].direction) {
+            kind = (GestureKind)k;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Recognizer thresholds, in milliseconds and screen pixels
+struct GestureThresholds {
+    int tap_ms;             // Longest touch that is still a tap
+    int double_tap_ms;      // Longest gap between the taps of a double tap
+    int long_press_ms;      // Hold time of a long press
+    int tap_move_px;        // Travel allowed in a tap or long press
+    int swipe_px;           // Travel of the fingers' center that makes a swipe
+    int pinch_px;           // Change in finger spread that makes a pinch
+
+    GestureThresholds()
+        : tap_ms(300), double_tap_ms(300), long_press_ms(600), tap_move_px(30), swipe_px(150), pinch_px(100) {}
+
+    // Applies key=value if key is a threshold
+    bool set(const std::string& key, const std::string& value) {
+        int* field = key == "tap_ms" ? &tap_ms
+                   : key == "double_tap_ms" ? &double_tap_ms
+                   : key == "long_press_ms" ? &long_press_ms
+                   : key == "tap_move_px" ? &tap_move_px
+                   : key == "swipe_px" ? &swipe_px
+                   : key == "pinch_px" ? &pinch_px
+                   : NULL;
+        if (!field) return false;
+        *field = atoi(value.c_str());
+        return true;
+    }
+};
+
+// What a gesture does (actions.h)
+enum ActionKind {
+    ACTION_COMMAND,             // External command
+    ACTION_DRAW,                // Lamp commands in argument
+    ACTION_REDRAW,
+    ACTION_PAGE_NEXT,
+    ACTION_PAGE_PREV,
+    ACTION_ITEM_NEXT,
+    ACTION_ITEM_PREV,
+    ACTION_SELECT
+};
+
+// Parses action=<value>. A draw's argument becomes its lamp commands, one
+// per line.
+inline bool parse_action(const std::string& value, ActionKind& action, std::string& argument) {
+    static const struct { const char* name; ActionKind action; } names[] = {
+        { "redraw", ACTION_REDRAW },       { "page next", ACTION_PAGE_NEXT }, { "page prev", ACTION_PAGE_PREV },
+        { "item next", ACTION_ITEM_NEXT }, { "item prev", ACTION_ITEM_PREV }, { "select", ACTION_SELECT },
+    };
+    if (value.compare(0, 5, "draw ") == 0) {
+        action = ACTION_DRAW;
+        argument.clear();
+        size_t pos = 5;
+        while (pos <= value.size()) {
+            size_t end = value.find(';', pos);
+            if (end == std::string::npos) end = value.size();
+            size_t first = value.find_first_not_of(" \t", pos);
+            size_t last = value.find_last_not_of(" \t", end - 1);
+            if (first < end && last != std::string::npos && last >= first) {
+                argument += value.substr(first, last - first + 1) + "\n";
+            }
+            pos = end + 1;
+        }
+        return !argument.empty();
+    }
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (value == names[i].name) {
+            action = names[i].action;
+            return true;
+        }
+    }
+    return false;
+}
+
+// A screen rectangle gestures can be bound to
+struct GestureRegion {
+    std::string name;
+    int x, y, width, height;
+
+    bool contains(int px, int py) const {
+        return px >= x && px < x + width && py >= y && py < y + height;
+    }
+};
+
+struct GestureConfig {
+    std::string gesture_type;  // "tap", "swipe", ...
+    std::string direction;      // Swipes and pinches
+    int fingers;
+    std::string command;        // External command, or the action as written
+    ActionKind action;
+    std::string argument;       // Lamp commands of a draw action
+    GestureKind kind;           // Parsed gesture_type and direction
+    std::string region_name;    // As configured, empty for the whole screen
+    int region;
+
+    GestureConfig() : fingers(0), action(ACTION_COMMAND), kind(GESTURE_TAP), region(0) {}
+};
+
+class GestureTable {
+private:
+    std::vector<GestureConfig> gestures;   // As configured, in order
+    std::vector<GestureRegion> regions;    // [0] is the whole screen
+    GestureThresholds limits;
+    short entries[GESTURE_KINDS][MAX_FINGERS + 1][GESTURE_REGIONS];     // Index into gestures, -1 none
+    uint8_t grid[REGION_ROWS][REGION_COLS];    // Bit per named region overlapping the cell
+
+    void reset_regions() {
+        regions.clear();
+        GestureRegion screen = { "screen", 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+        regions.push_back(screen);
+    }
+
+    int find_region(const std::string& name) const {
+        for (size_t r = 0; r < regions.size(); r++) {
+            if (regions[r].name == name) return r;
+        }
+        return -1;
+    }
+
+    // region.<name>=<x> <y> <width> <height>
+    void define_region(const std::string& name, const std::string& value) {
+        GestureRegion r = { name, 0, 0, 0, 0 };
+        if (name.empty() || sscanf(value.c_str(), "%d %d %d %d", &r.x, &r.y, &r.width, &r.height) != 4 ||
+            r.width <= 0 || r.height <= 0) {
+            fprintf(stderr, "Warning: Region '%s' needs x y width height, skipped\n", name.c_str());
+        } else if (find_region(name) >= 0) {
+            fprintf(stderr, "Warning: Region '%s' defined twice, the first kept\n", name.c_str());
+        } else if (regions.size() >= GESTURE_REGIONS) {
+            fprintf(stderr, "Warning: More than %d regions, '%s' skipped\n", GESTURE_REGIONS - 1, name.c_str());
+        } else {
+            regions.push_back(r);
+        }
+    }
+
+    // Region names to indices, once all are defined
+    void bind_regions() {
+        std::vector<GestureConfig> bound;
+        for (size_t i = 0; i < gestures.size(); i++) {
+            GestureConfig& g = gestures[i];
+            int r = g.region_name.empty() ? 0 : find_region(g.region_name);
+            if (r < 0) {
+                fprintf(stderr, "Warning: %d-finger %s in unknown region '%s', skipped\n", g.fingers,
+                        gesture_kind_name(g.kind), g.region_name.c_str());
+                continue;
+            }
+            g.region = r;
+            bound.push_back(g);
+        }
+        gestures.swap(bound);
+    }
+
+    // Checks one parsed block and keeps it if it can ever fire
+    void add(GestureConfig& g) {
+        if (!parse_gesture_kind(g.gesture_type, g.direction, g.kind)) {
+            fprintf(stderr, "Warning: Unknown gesture '%s%s%s', skipped\n", g.gesture_type.c_str(),
+                    g.direction.empty() ? "" : " ", g.direction.c_str());
+            return;
+        }
+        if (g.fingers < 1 || g.fingers > MAX_FINGERS) {
+            fprintf(stderr, "Warning: %s with %d fingers not supported (1-%d), skipped\n",
+                    g.gesture_type.c_str(), g.fingers, MAX_FINGERS);
+            return;
+        }
+        gestures.push_back(g);
+    }
+
+    void compile() {
+        for (int k = 0; k < GESTURE_KINDS; k++) {
+            for (int f = 0; f <= MAX_FINGERS; f++) {
+                for (int r = 0; r < GESTURE_REGIONS; r++) entries[k][f][r] = -1;
+            }
+        }
+        for (size_t i = 0; i < gestures.size(); i++) {
+            const GestureConfig& g = gestures[i];
+            short& e = entries[g.kind][g.fingers][g.region];
+            if (e >= 0) {
+                fprintf(stderr, "Warning: %d-finger %s configured twice%s%s, '%s' ignored\n", g.fingers,
+                        gesture_kind_name(g.kind), g.region ? " in " : "", g.region_name.c_str(), g.command.c_str());
+                continue;
+            }
+            e = (short)i;
+        }
+        // The whole screen's gestures where a region has none of its own
+        for (int k = 0; k < GESTURE_KINDS; k++) {
+            for (int f = 0; f <= MAX_FINGERS; f++) {
+                for (int r = 1; r < GESTURE_REGIONS; r++) {
+                    if (entries[k][f][r] < 0) entries[k][f][r] = entries[k][f][0];
+                }
+            }
+        }
+
+        memset(grid, 0, sizeof(grid));
+        for (size_t r = 1; r < regions.size(); r++) {
+            const GestureRegion& g = regions[r];
+            int col0 = g.x < 0 ? 0 : g.x / REGION_CELL, row0 = g.y < 0 ? 0 : g.y / REGION_CELL;
+            int col1 = (g.x + g.width - 1) / REGION_CELL, row1 = (g.y + g.height - 1) / REGION_CELL;
+            if (col1 >= REGION_COLS) col1 = REGION_COLS - 1;
+            if (row1 >= REGION_ROWS) row1 = REGION_ROWS - 1;
+            for (int row = row0; row <= row1; row++) {
+                for (int col = col0; col <= col1; col++) grid[row][col] |= 1 << r;
+            }
+        }
+    }
+
+public:
+    GestureTable() {
+        reset_regions();
+        compile();
+    }
+
+    bool load(const char* config_file) {
+        std::ifstream file(config_file);
+        if (!file.is_open()) {
+            fprintf(stderr, "Warning: Could not open config file: %s\n", config_file);
+            return false;
+        }
+
+        gestures.clear();
+        reset_regions();
+        limits = GestureThresholds();
+        GestureConfig current;
+        std::string line;
+
+        while (std::getline(file, line)) {
+            // Trim whitespace
+            size_t start = line.find_first_not_of(" \t\r\n");
+            if (start == std::string::npos) {
+                // Empty line - end of gesture definition
+                if (!current.gesture_type.empty() && !current.command.empty()) {
+                    add(current);
+                    current = GestureConfig();
+                }
+                continue;
+            }
+
+            // Skip comments
+            if (line[start] == '#') continue;
+
+            line = line.substr(start);
+            size_t end = line.find_last_not_of(" \t\r\n");
+            if (end != std::string::npos) {
+                line = line.substr(0, end + 1);
+            }
+
+            // Parse key=value
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+
+            if (key == "gesture") {
+                current.gesture_type = value;
+            } else if (key == "direction") {
+                current.direction = value;
+            } else if (limits.set(key, value)) {
+                continue;
+            } else if (key.compare(0, 7, "region.") == 0) {
+                define_region(key.substr(7), value);
+            } else if (key == "region") {
+                current.region_name = value;
+            } else if (key == "fingers") {
+                current.fingers = atoi(value.c_str());
+            } else if (key == "command") {
+                current.command = value;
+                current.action = ACTION_COMMAND;
+            } else if (key == "action") {
+                current.command = value;
+                if (!parse_action(value, current.action, current.argument)) {
+                    fprintf(stderr, "Warning: Unknown action '%s'\n", value.c_str());
+                    current.command.clear();
+                }
+            }
+        }
+
+        // Don't forget last gesture
+        if (!current.gesture_type.empty() && !current.command.empty()) {
+            add(current);
+        }
+
+        file.close();
+        bind_regions();
+        compile();
+        printf("Loaded %d gesture(s) from config", (int)gestures.size());
+        if (regions.size() > 1) printf(", %d region(s)", (int)regions.size() - 1);
+        printf("\n");
+        return true;
+    }
+
+    // Region of a screen point: the first named one holding it, else 0
+    int region_at(int x, int y) const {
+        if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return 0;
+        for (unsigned m = grid[y / REGION_CELL][x / REGION_CELL]; m; m &= m - 1) {
+            int r = __builtin_ctz(m);
+            if (regions[r].contains(x, y)) return r;
+        }
+        return 0;
+    }
+
+    const char* region_name(int region) const {
+        return region >= 0 && region < (int)regions.size() ? regions[region].name.c_str() : "unknown";
+    }
+
+    // The gesture for a kind, finger count and region, NULL if none. A
+    // region without its own gets the whole screen's.
+    const GestureConfig* lookup(GestureKind kind, int fingers, int region) const {
+        if (fingers < 1 || fingers > MAX_FINGERS) return NULL;
+        short e = entries[kind][fingers][region];
+        return e >= 0 ? &gestures[e] : NULL;
+    }
+
+    bool has(GestureKind kind, int fingers, int region) const {
+        return lookup(kind, fingers, region) != NULL;
+    }
+
+    const GestureThresholds& thresholds() const {
+        return limits;
+    }
+
+    int size() const {
+        return gestures.size();
+    }
+
+    const std::vector<GestureConfig>& configured() const {
+        return gestures;
+    }
+};
+
+#endif  // GENIE_GESTURE_TABLE_H
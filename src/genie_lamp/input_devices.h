@@ -0,0 +1,322 @@
+// Input Devices - capability discovery and hot-plug for genie_lamp
+//
+// Every /dev/input/event* node is probed the way lamp's identify_device()
+// does: multitouch axes (ABS_MT_POSITION_X) make a touch screen, plain
+// ABS_X a stylus. Matching devices are opened non-blocking and watched
+// together through one epoll instance, along with an inotify watch on
+// /dev/input, so devices that appear, disappear or get renumbered are
+// picked up without a restart, a thread or a blocking read per device.
+//
+// Event timestamps are switched to CLOCK_MONOTONIC, so they compare with
+// elxnk::monotonic_us() (elxnk/latency.h) and do not jump with the wall clock.
+//
+// The caller owns the loop: wait() returns ready devices and the caller reads
+// them. A device whose read fails (ENODEV once unplugged) is dropped with
+// remove(). Other descriptors the loop serves can be added with watch().
+//
+// Touch screens are numbered from 0, the lowest number not in use, so the
+// caller can keep state per screen; take_removed() tells which numbers were
+// given up since, by either kind of removal.
+
+#ifndef GENIE_INPUT_DEVICES_H
+#define GENIE_INPUT_DEVICES_H
+
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define INPUT_DIR "/dev/input"
+#define MAX_READY 8
+
+enum DeviceKind { DEVICE_UNKNOWN, DEVICE_TOUCH, DEVICE_STYLUS };
+
+inline const char* device_kind_name(DeviceKind kind) {
+    return kind == DEVICE_TOUCH ? "touch" : kind == DEVICE_STYLUS ? "stylus" : "unknown";
+}
+
+inline bool test_bit(const unsigned char* bits, int bit) {
+    return bits[bit / 8] & (1 << (bit % 8));
+}
+
+// Capability probe, same rules as lamp's identify_device()
+inline DeviceKind identify_device(int fd) {
+    unsigned char evbit[EV_MAX / 8 + 1];
+    memset(evbit, 0, sizeof(evbit));
+    if (ioctl(fd, EVIOCGBIT(0, sizeof(evbit)), evbit) < 0 || !test_bit(evbit, EV_ABS)) {
+        return DEVICE_UNKNOWN;
+    }
+
+    unsigned char absbit[ABS_MAX / 8 + 1];
+    memset(absbit, 0, sizeof(absbit));
+    if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absbit)), absbit) < 0) return DEVICE_UNKNOWN;
+    if (test_bit(absbit, ABS_MT_POSITION_X)) return DEVICE_TOUCH;
+    if (test_bit(absbit, ABS_X)) return DEVICE_STYLUS;
+    return DEVICE_UNKNOWN;
+}
+
+struct InputDevice {
+    int fd;
+    DeviceKind kind;
+    int slots;                  // Multitouch slots (ABS_MT_SLOT max + 1), touch only
+    int touch_index;            // Number among the touch screens, -1 for a stylus
+    std::string path;
+    std::string name;
+};
+
+// A device with events to read, as returned by InputDevices::wait()
+struct ReadyDevice {
+    int fd;
+    DeviceKind kind;
+    int slots;
+    int touch_index;
+};
+
+// Number of multitouch slots a touch device reports, 1 without ABS_MT_SLOT
+inline int touch_slots(int fd) {
+    struct input_absinfo abs;
+    if (ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &abs) < 0 || abs.maximum < 0) return 1;
+    return abs.maximum + 1;
+}
+
+// Per-slot values of one multitouch axis (EVIOCGMTSLOTS). values holds
+// count + 1 entries; the slots' values start at values[1].
+inline bool read_mt_slots(int fd, int code, int32_t* values, int count) {
+    values[0] = code;
+    return ioctl(fd, EVIOCGMTSLOTS((count + 1) * sizeof(int32_t)), values) >= 0;
+}
+
+class InputDevices {
+private:
+    int epoll_fd;
+    int inotify_fd;
+    std::vector<InputDevice> devices;
+    std::vector<int> watched;           // Caller's own descriptors
+    std::vector<int> removed_touch;     // Touch numbers given up, see take_removed()
+
+    bool is_event_node(const char* name) const {
+        return strncmp(name, "event", 5) == 0;
+    }
+
+    int find_path(const std::string& path) const {
+        for (size_t i = 0; i < devices.size(); i++) {
+            if (devices[i].path == path) return (int)i;
+        }
+        return -1;
+    }
+
+    int find_fd(int fd) const {
+        for (size_t i = 0; i < devices.size(); i++) {
+            if (devices[i].fd == fd) return (int)i;
+        }
+        return -1;
+    }
+
+    // Lowest touch screen number not in use
+    int free_touch_index() const {
+        for (int index = 0;; index++) {
+            size_t i = 0;
+            while (i < devices.size() && devices[i].touch_index != index) i++;
+            if (i == devices.size()) return index;
+        }
+    }
+
+    // Open and probe one node; keeps it if it is a touch screen or stylus
+    void add(const std::string& path) {
+        if (find_path(path) >= 0) return;
+
+        int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) return;     // Not ready yet (udev), retried on IN_ATTRIB
+
+        DeviceKind kind = identify_device(fd);
+        if (kind == DEVICE_UNKNOWN) {
+            close(fd);
+            return;
+        }
+
+        int clock = CLOCK_MONOTONIC;
+        if (ioctl(fd, EVIOCSCLOCKID, &clock) < 0) {
+            fprintf(stderr, "Warning: %s keeps wall clock timestamps\n", path.c_str());
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            perror("epoll_ctl");
+            close(fd);
+            return;
+        }
+
+        char name[128] = "";
+        ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+
+        InputDevice dev;
+        dev.fd = fd;
+        dev.kind = kind;
+        dev.slots = kind == DEVICE_TOUCH ? touch_slots(fd) : 0;
+        dev.touch_index = kind == DEVICE_TOUCH ? free_touch_index() : -1;
+        dev.path = path;
+        dev.name = name;
+        devices.push_back(dev);
+        printf("Input: %s %s (%s)\n", device_kind_name(kind), path.c_str(), name);
+    }
+
+    void remove_at(int index) {
+        const InputDevice& dev = devices[index];
+        printf("Input: removed %s %s\n", device_kind_name(dev.kind), dev.path.c_str());
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, dev.fd, NULL);
+        close(dev.fd);
+        if (dev.touch_index >= 0) removed_touch.push_back(dev.touch_index);
+        devices.erase(devices.begin() + index);
+    }
+
+    // Drain inotify: nodes created or made readable are probed, deleted
+    // ones dropped. Renumbering shows up as a delete plus a create.
+    void handle_inotify() {
+        char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t n;
+        while ((n = read(inotify_fd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + n;) {
+                const struct inotify_event* ie = (const struct inotify_event*)p;
+                p += sizeof(struct inotify_event) + ie->len;
+                if (!ie->len || !is_event_node(ie->name)) continue;
+
+                std::string path = std::string(INPUT_DIR "/") + ie->name;
+                if (ie->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    int i = find_path(path);
+                    if (i >= 0) remove_at(i);
+                } else {
+                    add(path);
+                }
+            }
+        }
+        if (n < 0 && errno == EOVERFLOW) scan();
+    }
+
+public:
+    InputDevices() : epoll_fd(-1), inotify_fd(-1) {}
+
+    ~InputDevices() {
+        while (!devices.empty()) remove_at((int)devices.size() - 1);
+        if (inotify_fd >= 0) close(inotify_fd);
+        if (epoll_fd >= 0) close(epoll_fd);
+    }
+
+    // Set up epoll and the hot-plug watch, then probe existing nodes.
+    // Hot-plug is optional: without inotify, only the initial scan applies.
+    bool open_all() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            perror("epoll_create1");
+            return false;
+        }
+
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd >= 0 &&
+            inotify_add_watch(inotify_fd, INPUT_DIR, IN_CREATE | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM |
+                                                     IN_MOVED_TO) >= 0) {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLIN;
+            ev.data.fd = inotify_fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, inotify_fd, &ev);
+        } else {
+            perror("inotify (hot-plug disabled)");
+        }
+
+        scan();
+        return true;
+    }
+
+    // Probe every event node not open yet
+    void scan() {
+        DIR* d = opendir(INPUT_DIR);
+        if (!d) return;
+        struct dirent* e;
+        while ((e = readdir(d)) != NULL) {
+            if (is_event_node(e->d_name)) add(std::string(INPUT_DIR "/") + e->d_name);
+        }
+        closedir(d);
+    }
+
+    // Also wait for fd; it comes back in ready as kind DEVICE_UNKNOWN and
+    // is the caller's to read
+    bool watch(int fd) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            perror("epoll_ctl");
+            return false;
+        }
+        watched.push_back(fd);
+        return true;
+    }
+
+    int count(DeviceKind kind) const {
+        int n = 0;
+        for (size_t i = 0; i < devices.size(); i++) n += devices[i].kind == kind;
+        return n;
+    }
+
+    // Wait for input, at most timeout_ms (-1: no limit); hot-plug is handled
+    // internally. Fills ready with the devices that have events. Returns
+    // false on error; a signal or the timeout returns true with nothing
+    // ready, so the caller can handle it.
+    bool wait(std::vector<ReadyDevice>& ready, int timeout_ms = -1) {
+        ready.clear();
+        struct epoll_event events[MAX_READY];
+        int n = epoll_wait(epoll_fd, events, MAX_READY, timeout_ms);
+        if (n < 0) return errno == EINTR;
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.fd == inotify_fd) {
+                handle_inotify();
+                ready.clear();      // Device list changed; level-triggered epoll
+                return true;        // reports the others again
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            int index = find_fd(events[i].data.fd);
+            if (index >= 0) {
+                const InputDevice& dev = devices[index];
+                ReadyDevice r = { dev.fd, dev.kind, dev.slots, dev.touch_index };
+                ready.push_back(r);
+            } else {
+                ReadyDevice r = { events[i].data.fd, DEVICE_UNKNOWN, 0, -1 };
+                ready.push_back(r);
+            }
+        }
+        return true;
+    }
+
+    // Drop a device that went away (read returned ENODEV or EOF)
+    void remove(int fd) {
+        int index = find_fd(fd);
+        if (index >= 0) remove_at(index);
+    }
+
+    // A touch screen number given up since the last call, oldest first;
+    // false when there is none
+    bool take_removed(int& touch_index) {
+        if (removed_touch.empty()) return false;
+        touch_index = removed_touch.front();
+        removed_touch.erase(removed_touch.begin());
+        return true;
+    }
+};
+
+#endif  // GENIE_INPUT_DEVICES_H
@@ -1,207 +1,132 @@
 // Standalone gesture detector for reMarkable 2
 // No rmkit dependencies - uses only Linux input API
+//
+// Touch screens and styluses are found by capability and watched together
+// through epoll, with hot-plug via inotify (see input_devices.h). Touch
+// events drive the gestures (gesture_detector.h); the stylus only reports
+// whether the pen is on the screen, which holds touch gestures off while
+// writing. Strokes lamp draws itself come through the same stylus device
+// and are left out (elxnk/lamp_pen.h). The wait is bounded by the
+// detector's next deadline, so long presses and held taps fire on time
+// without polling.
+//
+// Recognized gestures are handed to a worker thread (ActionQueue in
+// actions.h), so this loop keeps reading input while an action runs.
+//
+// The config is reloaded when it changes (config_watch.h). The new gesture
+// table is built on another thread and put in between touch sequences, so
+// no restart and no touch state lost.
 
 #include <linux/input.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <map>
 #include <vector>
-#include <set>
+#include "actions.h"
+#include "config_watch.h"
+#include "gesture_detector.h"
+#include "input_devices.h"
+#include "../elxnk/lamp_pen.h"
+#include "../elxnk/latency.h"
 
-#define TOUCH_DEVICE "/dev/input/event2"
 #define DEFAULT_CONFIG "/opt/etc/genie_lamp.conf"
 
-struct GestureConfig {
-    std::string gesture_type;  // "tap"
-    int fingers;
-    std::string command;
-
-    GestureConfig() : fingers(0) {}
-};
+// Events fetched per read(). The kernel hands out whole events, as many as
+// are queued and fit; a multitouch frame on the rM2 is a few dozen events.
+#define READ_BATCH 64
+
+// Input loop counters, printed on SIGUSR1 and at exit
+struct InputStats {
+    unsigned long reads;        // read() calls that returned events
+    unsigned long events;
+    unsigned long frames;       // SYN_REPORTs
+    unsigned long full_reads;   // Reads that filled the whole batch
+    unsigned long drops;        // SYN_DROPPEDs: kernel buffer overflowed
+    int max_batch;
+
+    InputStats() : reads(0), events(0), frames(0), full_reads(0), drops(0), max_batch(0) {}
+
+    void add_read(int count) {
+        reads++;
+        events += count;
+        if (count == READ_BATCH) full_reads++;
+        if (count > max_batch) max_batch = count;
+    }
 
-struct TouchPoint {
-    int tracking_id;
-    int x;
-    int y;
-    bool active;
+    void print() const {
+        printf("Input: %lu events, %lu frames, %lu reads (%.2f reads/frame, %.1f events/read, "
+               "max %d, %lu full), %lu overflows\n",
+               events, frames, reads, frames ? (double)reads / frames : 0.0,
+               reads ? (double)events / reads : 0.0, max_batch, full_reads, drops);
+        fflush(stdout);
+    }
 };
 
-class SimpleGestureDetector {
+// Queues the action of each gesture as it is recognized, with a new trace
+class GestureLauncher : public SimpleGestureDetector {
 private:
-    std::map<int, TouchPoint> touches;
-    int current_slot;
-    TouchPoint pending_update;
-    bool has_pending;
-    std::set<int> active_ids;
-    std::vector<GestureConfig> gestures;
-    std::map<int, bool> gesture_fired;      // Track if gesture with N fingers fired
-    std::map<int, int> gesture_cooldown;    // Cooldown per finger count
+    unsigned traces;
 
 public:
-    SimpleGestureDetector() : current_slot(0), has_pending(false) {
-        pending_update.tracking_id = -1;
-        pending_update.x = 0;
-        pending_update.y = 0;
-        pending_update.active = false;
-    }
-
-    void load_config(const char* config_file) {
-        std::ifstream file(config_file);
-        if (!file.is_open()) {
-            fprintf(stderr, "Warning: Could not open config file: %s\n", config_file);
-            return;
-        }
-
-        GestureConfig current;
-        std::string line;
-        int gesture_count = 0;
-
-        while (std::getline(file, line)) {
-            // Trim whitespace
-            size_t start = line.find_first_not_of(" \t\r\n");
-            if (start == std::string::npos) {
-                // Empty line - end of gesture definition
-                if (!current.gesture_type.empty() && !current.command.empty()) {
-                    gestures.push_back(current);
-                    gesture_count++;
-                    current = GestureConfig();
-                }
-                continue;
-            }
-
-            // Skip comments
-            if (line[start] == '#') continue;
-
-            line = line.substr(start);
-            size_t end = line.find_last_not_of(" \t\r\n");
-            if (end != std::string::npos) {
-                line = line.substr(0, end + 1);
-            }
+    ActionQueue actions;
 
-            // Parse key=value
-            size_t eq = line.find('=');
-            if (eq == std::string::npos) continue;
-
-            std::string key = line.substr(0, eq);
-            std::string value = line.substr(eq + 1);
-
-            if (key == "gesture") {
-                current.gesture_type = value;
-            } else if (key == "fingers") {
-                current.fingers = atoi(value.c_str());
-            } else if (key == "command") {
-                current.command = value;
-            }
-        }
+    GestureLauncher() : traces(0) {}
 
-        // Don't forget last gesture
-        if (!current.gesture_type.empty() && !current.command.empty()) {
-            gestures.push_back(current);
-            gesture_count++;
-        }
-
-        file.close();
-        printf("Loaded %d gesture(s) from config\n", gesture_count);
+    void fire(const GestureConfig& g, int finger_count) {
+        GestureTrace trace = { ++traces, cause_us(), elxnk::monotonic_us(), 0 };
+        actions.latency.recognize.add(trace.recognized_us - trace.event_us);
+        printf("%d-finger %s%s%s detected! (trace %u)\n", finger_count, gesture_kind_name(g.kind),
+               g.region ? " in " : "", g.region_name.c_str(), trace.id);
+        actions.push(g, current_table(), trace);
     }
+};
 
-    void process_event(const struct input_event& ev) {
-        if (ev.type == EV_ABS) {
-            switch (ev.code) {
-                case ABS_MT_SLOT:
-                    current_slot = ev.value;
-                    break;
-
-                case ABS_MT_TRACKING_ID:
-                    if (ev.value == -1) {
-                        // Touch lifted
-                        touches.erase(current_slot);
-                        active_ids.erase(current_slot);
-                    } else {
-                        // New touch
-                        pending_update.tracking_id = ev.value;
-                        pending_update.active = true;
-                        has_pending = true;
-                        active_ids.insert(current_slot);
-                    }
-                    break;
-
-                case ABS_MT_POSITION_X:
-                    pending_update.x = ev.value;
-                    has_pending = true;
-                    break;
-
-                case ABS_MT_POSITION_Y:
-                    pending_update.y = ev.value;
-                    has_pending = true;
-                    break;
-            }
-        } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
-            // End of event frame
-            if (has_pending && pending_update.active) {
-                touches[current_slot] = pending_update;
-                pending_update.active = false;
-                has_pending = false;
-            }
-
-            // Check gestures
-            detect_gestures();
-        }
-    }
-
-    void detect_gestures() {
-        int finger_count = active_ids.size();
-
-        // Update cooldowns
-        for (auto& pair : gesture_cooldown) {
-            if (pair.second > 0) pair.second--;
-        }
-
-        // Reset gesture_fired when fingers are lifted
-        if (finger_count == 0) {
-            gesture_fired.clear();
-        }
-
-        // Check each configured gesture
-        for (const auto& g : gestures) {
-            if (g.gesture_type == "tap" && g.fingers == finger_count) {
-                // Check cooldown
-                if (gesture_cooldown[finger_count] > 0) continue;
-
-                // Check if not already fired
-                if (gesture_fired[finger_count]) continue;
-
-                // Fire the gesture
-                printf("%d-finger tap detected!\n", finger_count);
-                run_command(g.command);
-                gesture_fired[finger_count] = true;
-                gesture_cooldown[finger_count] = 30; // Cooldown frames
-            }
-        }
+// Events were lost: read the slots back from the device. If that fails
+// every touch is taken as lifted.
+static void resync_touch(const ReadyDevice& dev, SimpleGestureDetector& detector) {
+    int fd = dev.fd, slots = dev.slots;
+    if (slots > MAX_SLOTS) slots = MAX_SLOTS;
+    int32_t ids[MAX_SLOTS + 1], xs[MAX_SLOTS + 1], ys[MAX_SLOTS + 1];
+    struct input_absinfo slot;
+    memset(&slot, 0, sizeof(slot));
+    if (!read_mt_slots(fd, ABS_MT_TRACKING_ID, ids, slots) || !read_mt_slots(fd, ABS_MT_POSITION_X, xs, slots) ||
+        !read_mt_slots(fd, ABS_MT_POSITION_Y, ys, slots) || ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &slot) < 0) {
+        perror("EVIOCGMTSLOTS");
+        for (int s = 0; s <= slots; s++) ids[s] = -1;
     }
+    detector.resync(ids + 1, xs + 1, ys + 1, slot.value, elxnk::monotonic_us(), dev.touch_index);
+}
 
-    void run_command(const std::string& cmd) {
-        std::string command = cmd + " &";
-        printf("Running: %s\n", command.c_str());
+// Stylus state after events were lost: whether the pen touches now is read
+// from the device (fd -1: none, the pen is up), and it is lamp's only if
+// lamp is drawing now
+static void resync_pen(int fd, SimpleGestureDetector& detector, elxnk::LampPen& lamp_pen) {
+    unsigned char keys[KEY_MAX / 8 + 1];
+    memset(keys, 0, sizeof(keys));
+    if (fd >= 0 && ioctl(fd, EVIOCGKEY(sizeof(keys)), keys) < 0) perror("EVIOCGKEY");
 
-        int ret = system(command.c_str());
-        if (ret != 0) {
-            fprintf(stderr, "Warning: Command returned %d\n", ret);
-        }
+    long long now = elxnk::monotonic_us();
+    struct input_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.time.tv_sec = now / 1000000;
+    ev.time.tv_usec = now % 1000000;
+    ev.type = EV_KEY;
+    ev.code = BTN_TOUCH;
+    ev.value = test_bit(keys, BTN_TOUCH);
+    lamp_pen.reset();
+    if (!lamp_pen.owns(ev)) detector.process_pen_event(ev);
+}
 
-        // Small delay to let gesture reset
-        usleep(50000);
-    }
+static volatile sig_atomic_t stats_requested = 0;
 
-    int get_gesture_count() const {
-        return gestures.size();
-    }
-};
+static void request_stats(int) {
+    stats_requested = 1;
+}
 
 int main(int argc, char** argv) {
     const char* config_file = DEFAULT_CONFIG;
@@ -213,9 +138,8 @@ int main(int argc, char** argv) {
 
     printf("Starting genie_lamp - standalone gesture detector\n");
     printf("Config file: %s\n", config_file);
-    printf("Touch device: %s\n", TOUCH_DEVICE);
 
-    SimpleGestureDetector detector;
+    GestureLauncher detector;
     detector.load_config(config_file);
 
     if (detector.get_gesture_count() == 0) {
@@ -224,30 +148,118 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    int fd = open(TOUCH_DEVICE, O_RDONLY);
-    if (fd < 0) {
-        perror("Failed to open touch device");
-        fprintf(stderr, "Make sure %s exists and is readable\n", TOUCH_DEVICE);
-        return 1;
+    InputDevices inputs;
+    if (!inputs.open_all()) return 1;
+    if (inputs.count(DEVICE_TOUCH) == 0) {
+        fprintf(stderr, "No touch device in %s yet, waiting for one\n", INPUT_DIR);
     }
 
-    printf("Successfully opened touch device\n");
+    ConfigWatch config;
+    if (config.open(config_file)) {
+        inputs.watch(config.change_fd());
+        inputs.watch(config.ready_fd());
+    }
+    std::shared_ptr<const GestureTable> next_table;     // Reloaded, waiting for idle
+
+    elxnk::LampPen lamp_pen;            // Mapped once lamp has created it
+    lamp_pen.open();
+    int styluses = inputs.count(DEVICE_STYLUS);
+    bool pen_dropping = false;          // Stylus events lost, until SYN_REPORT
+
+    detector.actions.start();
     printf("Waiting for gestures...\n");
 
-    struct input_event ev;
+    // SIGUSR1 prints the input, action and latency counters; no SA_RESTART,
+    // so a blocked epoll_wait() returns EINTR and the loop prints them now
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = request_stats;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    struct input_event events[READ_BATCH];
+    std::vector<ReadyDevice> ready;
+    InputStats stats;
+
+    while (inputs.wait(ready, detector.timeout_ms(elxnk::monotonic_us()))) {
+        if (stats_requested) {
+            stats_requested = 0;
+            stats.print();
+            detector.actions.print_stats();
+        }
 
-    while (true) {
-        ssize_t n = read(fd, &ev, sizeof(ev));
-        if (n != sizeof(ev)) {
-            if (n < 0) {
-                perror("Error reading from touch device");
+        int gone;
+        while (inputs.take_removed(gone)) detector.remove_device(gone, elxnk::monotonic_us());
+
+        // A stylus came or went: its pen is up until it says otherwise
+        if (inputs.count(DEVICE_STYLUS) != styluses) {
+            styluses = inputs.count(DEVICE_STYLUS);
+            pen_dropping = false;
+            resync_pen(-1, detector, lamp_pen);
+        }
+
+        for (size_t d = 0; d < ready.size(); d++) {
+            if (ready[d].kind == DEVICE_UNKNOWN) {
+                if (ready[d].fd == config.change_fd()) {
+                    config.handle_change();
+                } else if (ready[d].fd == config.ready_fd()) {
+                    std::shared_ptr<const GestureTable> table = config.take();
+                    if (table) next_table = table;
+                }
+                continue;
+            }
+
+            ssize_t n = read(ready[d].fd, events, sizeof(events));
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+            if (n <= 0 || n % sizeof(struct input_event) != 0) {
+                if (n < 0 && errno != ENODEV) perror("Error reading input device");
+                inputs.remove(ready[d].fd);
+                continue;
+            }
+
+            // The whole batch in one pass; it can end mid-frame, the
+            // detector keeps its frame state across reads
+            int count = n / sizeof(struct input_event);
+            if (ready[d].kind == DEVICE_STYLUS) {
+                for (int i = 0; i < count; i++) {
+                    if (events[i].type == EV_SYN && events[i].code == SYN_DROPPED) {
+                        stats.drops++;
+                        pen_dropping = true;
+                    } else if (pen_dropping) {
+                        if (events[i].type != EV_SYN || events[i].code != SYN_REPORT) continue;
+                        pen_dropping = false;
+                        resync_pen(ready[d].fd, detector, lamp_pen);
+                    } else if (!lamp_pen.owns(events[i])) {
+                        detector.process_pen_event(events[i]);
+                    }
+                }
+                continue;
+            }
+
+            // Each touch screen keeps its own slots and frame state
+            int screen = ready[d].touch_index;
+            detector.set_slot_count(ready[d].slots, screen);
+            stats.add_read(count);
+            for (int i = 0; i < count; i++) {
+                detector.process_event(events[i], screen);
+                if (events[i].type != EV_SYN) continue;
+                if (events[i].code == SYN_REPORT) {
+                    stats.frames++;
+                    if (detector.resync_pending(screen)) resync_touch(ready[d], detector);
+                } else if (events[i].code == SYN_DROPPED) {
+                    stats.drops++;
+                }
             }
-            break;
         }
+        detector.tick(elxnk::monotonic_us());
 
-        detector.process_event(ev);
+        if (next_table && detector.idle()) {
+            detector.set_table(next_table);
+            next_table.reset();
+            printf("Config reloaded: %d gesture(s)\n", detector.get_gesture_count());
+        }
     }
 
-    close(fd);
-    return 0;
+    perror("epoll_wait");
+    stats.print();
+    return 1;
 }
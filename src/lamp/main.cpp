@@ -1,6 +1,27 @@
 // Standalone lamp - reMarkable 2 drawing engine
 // Converted from rmkit main.cpy to pure C++
 // Reads commands from stdin and writes to input devices
+// Also accepts placement requests (place/text) rendered from the
+// embedded component library, see elxnk/renderer.h
+//
+// A "trace <id> <event_us> <sent_us>" line from genie_lamp times the next
+// pen write, completing its gesture-to-ink latency (elxnk/latency.h);
+// "latency" prints lamp's histograms to stderr.
+//
+// When lamp draws on the stylus is published for genie_lamp, which would
+// otherwise take lamp's strokes for a hand writing (elxnk/lamp_pen.h).
+//
+// "mt" commands synthesize slot-based multitouch gestures on a virtual
+// touch screen (lamp/multitouch.h), to load-test genie_lamp:
+//   mt tap <fingers> <x> <y>
+//   mt swipe <fingers> <x> <y> <dx> <dy>
+//   mt pinch <fingers> <x> <y> <r1> <r2>
+//   mt palm <contacts> <x> <y> [frames]
+//   mt stress <count> [seed]       random mix, summary to stderr
+//   mt rate <hz>                   frames per second, 0 for no pacing
+//   mt gap <ms>                    pause after each gesture
+//   mt jitter <px>                 finger shake while held
+//   mt device uinput|touch         virtual screen (default) or the real one
 
 #include <linux/input.h>
 #include <string>
@@ -13,6 +34,12 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <algorithm>
+#include <map>
+#include <sys/ioctl.h>
+#include "../elxnk/lamp_pen.h"
+#include "../elxnk/latency.h"
+#include "../elxnk/renderer.h"
+#include "multitouch.h"
 
 // reMarkable 2 constants
 #define MTWIDTH 767
@@ -37,8 +64,25 @@ bool bsleep = false;
 int finger_x = 0, finger_y = 0, pen_x = 0, pen_y = 0;
 int touch_fd = -1, pen_fd = -1;
 
+// Gesture trace waiting for its first pen write
+bool trace_open = false;
+long long trace_event_us = 0, trace_sent_us = 0;
+elxnk::LatencyHistogram first_write_latency("first write");
+elxnk::LatencyHistogram total_latency("total");
+
+// When lamp draws, published for genie_lamp (elxnk/lamp_pen.h)
+elxnk::LampPen lamp_pen;
+
+// Multitouch synthesis
+MultiTouch mt;
+int mt_fd = -1;                 // uinput touch screen, created on first use
+bool mt_real = false;           // Write to touch_fd instead
+int mt_frame_us = 7000;         // The digitizer's report rate
+int mt_gap_ms = 400;            // Longer than genie_lamp's double tap window
+
 // Forward declarations
 void act_on_line(const std::string& line);
+void write_events(int fd, const std::vector<input_event>& events, int sleep_time = 1000);
 
 // Coordinate transformations
 int get_pen_x(int x) {
@@ -404,8 +448,16 @@ std::vector<input_event> finger_up() {
     return ev;
 }
 
+// BTN_TOUCH value a stylus frame sets, -1 if it has none
+int frame_touch(const std::vector<input_event>& frame) {
+    for (const auto& event : frame) {
+        if (event.type == EV_KEY && event.code == BTN_TOUCH) return event.value ? 1 : 0;
+    }
+    return -1;
+}
+
 // Write events to device
-void write_events(int fd, const std::vector<input_event>& events, int sleep_time = 1000) {
+void write_events(int fd, const std::vector<input_event>& events, int sleep_time) {
     if (fd < 0) return;
 
     std::vector<input_event> send;
@@ -413,10 +465,122 @@ void write_events(int fd, const std::vector<input_event>& events, int sleep_time
         send.push_back(event);
         if (event.type == EV_SYN) {
             if (sleep_time) usleep(sleep_time);
+            int touch = fd == pen_fd ? frame_touch(send) : -1;
+            if (fd == pen_fd) lamp_pen.before_frame(touch == 1);
             write(fd, send.data(), sizeof(input_event) * send.size());
+            if (touch == 0) lamp_pen.after_up();
             send.clear();
+            if (trace_open && fd == pen_fd) {
+                long long now = elxnk::monotonic_us();
+                first_write_latency.add(now - trace_sent_us);
+                total_latency.add(now - trace_event_us);
+                trace_open = false;
+            }
+        }
+    }
+}
+
+// Multitouch synthesis target
+int mt_device() {
+    if (mt_real) return touch_fd;
+    if (mt_fd < 0) mt_fd = create_uinput_touch();
+    return mt_fd;
+}
+
+// Write the gesture built, then pause; the number of events written
+size_t mt_send(int fd) {
+    std::vector<input_event> ev = mt.take();
+    write_events(fd, ev, mt_frame_us);
+    if (mt_gap_ms > 0) usleep(mt_gap_ms * 1000);
+    return ev.size();
+}
+
+// Random taps, swipes, pinches and palms, with a tally in genie_lamp's
+// names to compare against what it detected
+void mt_stress(int fd, int count) {
+    static const char* swipes[] = { "swipe left", "swipe right", "swipe up", "swipe down" };
+    static const int swipe_dx[] = { -400, 400, 0, 0 };
+    static const int swipe_dy[] = { 0, 0, -400, 400 };
+    std::map<std::string, int> tally;
+    size_t events = 0;
+    long long start = elxnk::monotonic_us();
+
+    for (int i = 0; i < count; i++) {
+        int x = 400 + mt.pick(600), y = 500 + mt.pick(800);
+        int fingers, kind = mt.pick(10);
+        std::string name;
+        if (kind < 4) {
+            fingers = 1 + mt.pick(5);
+            mt.tap(fingers, x, y);
+            name = "tap";
+        } else if (kind < 7) {
+            int dir = mt.pick(4);
+            fingers = 1 + mt.pick(3);
+            mt.swipe(fingers, x, y, swipe_dx[dir], swipe_dy[dir]);
+            name = swipes[dir];
+        } else if (kind < 9) {
+            bool out = mt.pick(2);
+            fingers = 2 + mt.pick(2);
+            mt.pinch(fingers, x, y, out ? 100 : 300, out ? 300 : 100);
+            name = out ? "pinch out" : "pinch in";
+        } else {
+            fingers = 3 + mt.pick(4);
+            mt.palm(fingers, x, y);
+            name = "palm (fires nothing)";
         }
+        events += mt_send(fd);
+        tally[std::to_string(fingers) + "-finger " + name]++;
+    }
+
+    double secs = (elxnk::monotonic_us() - start) / 1e6;
+    fprintf(stderr, "lamp: mt stress: %d gestures, %zu events in %.1f s (%.0f events/s)\n", count, events, secs,
+            secs > 0 ? events / secs : 0);
+    for (const auto& t : tally) fprintf(stderr, "  %-28s %d\n", t.first.c_str(), t.second);
+}
+
+void do_multitouch(const std::string& action, std::istringstream& ss) {
+    int fingers = 1, x = DISPLAYWIDTH / 2, y = DISPLAYHEIGHT / 2, a = 0, b = 0, frames = 60;
+
+    if (action == "rate") {
+        if (ss >> a && a >= 0) mt_frame_us = a > 0 ? 1000000 / a : 0;
+        return;
+    } else if (action == "gap") {
+        if (ss >> a && a >= 0) mt_gap_ms = a;
+        return;
+    } else if (action == "jitter") {
+        if (ss >> a && a >= 0) mt.jitter = a;
+        return;
+    } else if (action == "device") {
+        std::string which;
+        ss >> which;
+        mt_real = which == "touch";
+        return;
+    }
+
+    int fd = mt_device();
+    if (fd < 0) return;
+    if (action == "stress") {
+        unsigned int seed = 1;
+        ss >> a >> seed;
+        mt.set_seed(seed);
+        mt_stress(fd, a);
+        return;
     }
+
+    ss >> fingers >> x >> y >> a >> b;
+    if (action == "tap") {
+        mt.tap(fingers, x, y);
+    } else if (action == "swipe") {
+        mt.swipe(fingers, x, y, a, b);
+    } else if (action == "pinch") {
+        mt.pinch(fingers, x, y, a, b);
+    } else if (action == "palm") {
+        if (a > 0) frames = a;
+        mt.palm(fingers, x, y, frames);
+    } else {
+        return;
+    }
+    mt_send(fd);
 }
 
 // Identify device type by checking capabilities
@@ -450,10 +614,47 @@ EV_TYPE identify_device(int fd) {
     return UNKNOWN;
 }
 
+// Pen stroke actions shared by text commands and placement requests
+void do_pen_down(int x, int y) {
+    write_events(pen_fd, pen_down(x, y));
+    pen_x = x;
+    pen_y = y;
+}
+
+void do_pen_move(int x, int y, int sleep_val) {
+    write_events(pen_fd, pen_move(pen_x, pen_y, x, y, move_pts), sleep_val);
+    pen_x = x;
+    pen_y = y;
+}
+
+void do_pen_up() {
+    write_events(pen_fd, pen_up());
+}
+
+// Feeds placement strokes straight into the pen device
+class PenSink : public elxnk::StrokeSink {
+public:
+    void down(int x, int y) { do_pen_down(x, y); }
+    void move(int x, int y) { do_pen_move(x, y, 10); }
+    void up() { do_pen_up(); }
+    void circle(int cx, int cy, int r1, int r2) { pen_draw_circle(cx, cy, r1, r2); }
+    void raw(const char* cmd) { act_on_line(cmd); }
+};
+
 // Command processor
 void act_on_line(const std::string& line) {
     if (line.empty() || line[0] == '#') return;
 
+    // Placement requests (place/text) from the embedded library
+    PenSink sink;
+    char err[128];
+    elxnk::RequestStatus status = elxnk::handle_request(sink, line.c_str(), err, sizeof(err));
+    if (status == elxnk::REQUEST_OK) return;
+    if (status == elxnk::REQUEST_ERROR) {
+        std::cerr << "lamp: " << err << "\n";
+        return;
+    }
+
     std::istringstream ss(line);
     std::string tool, action;
     ss >> tool >> action;
@@ -466,17 +667,13 @@ void act_on_line(const std::string& line) {
     // Process pen commands
     if (tool == "pen" || tool == "fastpen") {
         if (action == "up") {
-            write_events(pen_fd, pen_up());
+            do_pen_up();
         } else if (action == "down") {
             ss >> x >> y;
-            write_events(pen_fd, pen_down(x, y));
-            pen_x = x;
-            pen_y = y;
+            do_pen_down(x, y);
         } else if (action == "move") {
             ss >> x >> y;
-            write_events(pen_fd, pen_move(pen_x, pen_y, x, y, move_pts), sleep_val);
-            pen_x = x;
-            pen_y = y;
+            do_pen_move(x, y, sleep_val);
         }
         // Geometry commands
         else if (action == "line") {
@@ -542,6 +739,20 @@ void act_on_line(const std::string& line) {
             finger_y = y;
         }
     }
+    // Multitouch synthesis
+    else if (tool == "mt") {
+        do_multitouch(action, ss);
+    }
+    // Gesture trace from genie_lamp: times the next pen write
+    else if (tool == "trace") {
+        unsigned id;
+        trace_open = (std::istringstream(action) >> id) && (ss >> trace_event_us >> trace_sent_us);
+    }
+    else if (tool == "latency") {
+        fprintf(stderr, "lamp latency:\n");
+        first_write_latency.print(stderr);
+        total_latency.print(stderr);
+    }
     // Sleep command
     else if (tool == "sleep") {
         int val = atoi(action.c_str());
@@ -571,10 +782,16 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // Let genie_lamp tell lamp's strokes from a hand's
+    lamp_pen.create();
+
     // Initialize devices
     write_events(touch_fd, finger_up());
     write_events(pen_fd, pen_clear());
 
+    // Library files for placement requests (embedded library is the fallback)
+    elxnk::library().load_default();
+
     // Read commands from stdin
     std::string line;
     while (std::getline(std::cin, line)) {
@@ -584,6 +801,10 @@ int main(int argc, char** argv) {
     // Cleanup
     write_events(touch_fd, finger_up());
     write_events(pen_fd, pen_up());
+    if (mt_fd >= 0) {
+        ioctl(mt_fd, UI_DEV_DESTROY);
+        close(mt_fd);
+    }
 
     close(fd0);
     close(fd1);
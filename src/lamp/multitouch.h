@@ -0,0 +1,228 @@
+// Multitouch synthesis - slot-based N-finger gestures for load-testing
+//
+// Builds protocol B multitouch frames, as the rM2 digitizer reports them:
+// every finger has its own slot (ABS_MT_SLOT) and a tracking ID for as long
+// as it is down, positions are updated per slot, and each frame ends with a
+// SYN_REPORT. Fingers land and lift one per frame and shake by jitter
+// pixels while held. Coordinates are screen pixels; the touch Y axis runs
+// bottom to top, as in lamp's finger helpers.
+//
+// The frames go to a uinput virtual touch screen (create_uinput_touch()),
+// which genie_lamp finds by capability like the real one, so load tests do
+// not reach xochitl. lamp paces them with write_events(): one frame per
+// 1/rate seconds.
+
+#ifndef LAMP_MULTITOUCH_H
+#define LAMP_MULTITOUCH_H
+
+#include <linux/input.h>
+#include <linux/uinput.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <vector>
+
+#define MT_MAX_FINGERS 10
+#define MT_SCREEN_WIDTH 1404
+#define MT_SCREEN_HEIGHT 1872
+#define MT_DEVICE_NAME "lamp multitouch"
+
+// A uinput device with the multitouch axes genie_lamp looks for; -1 on error
+inline int create_uinput_touch() {
+    int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        perror("lamp: /dev/uinput");
+        return -1;
+    }
+
+    static const int axes[] = { ABS_MT_SLOT, ABS_MT_TRACKING_ID, ABS_MT_POSITION_X, ABS_MT_POSITION_Y,
+                                ABS_MT_PRESSURE };
+    struct uinput_user_dev dev;
+    memset(&dev, 0, sizeof(dev));
+    snprintf(dev.name, sizeof(dev.name), MT_DEVICE_NAME);
+    dev.id.bustype = BUS_VIRTUAL;
+    dev.absmax[ABS_MT_SLOT] = MT_MAX_FINGERS - 1;
+    dev.absmax[ABS_MT_TRACKING_ID] = 65535;
+    dev.absmax[ABS_MT_POSITION_X] = MT_SCREEN_WIDTH - 1;
+    dev.absmax[ABS_MT_POSITION_Y] = MT_SCREEN_HEIGHT - 1;
+    dev.absmax[ABS_MT_PRESSURE] = 255;
+
+    bool ok = ioctl(fd, UI_SET_EVBIT, EV_SYN) >= 0 && ioctl(fd, UI_SET_EVBIT, EV_ABS) >= 0 &&
+              ioctl(fd, UI_SET_PROPBIT, INPUT_PROP_DIRECT) >= 0;
+    for (size_t i = 0; ok && i < sizeof(axes) / sizeof(axes[0]); i++) {
+        ok = ioctl(fd, UI_SET_ABSBIT, axes[i]) >= 0;
+    }
+    if (!ok || write(fd, &dev, sizeof(dev)) != (ssize_t)sizeof(dev) || ioctl(fd, UI_DEV_CREATE) < 0) {
+        perror("lamp: uinput setup");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Builds the frames of one gesture at a time; take() hands them over
+class MultiTouch {
+private:
+    std::vector<input_event> out;
+    int tracking_id;
+    unsigned int seed;
+    int x[MT_MAX_FINGERS], y[MT_MAX_FINGERS];
+
+    void abs(int code, int value) {
+        input_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.type = EV_ABS;
+        ev.code = code;
+        ev.value = value;
+        out.push_back(ev);
+    }
+
+    void frame() {
+        input_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.type = EV_SYN;
+        ev.code = SYN_REPORT;
+        out.push_back(ev);
+    }
+
+    static int clamp(int v, int limit) {
+        return v < 0 ? 0 : v >= limit ? limit - 1 : v;
+    }
+
+    void position(int f, int px, int py) {
+        abs(ABS_MT_SLOT, f);
+        abs(ABS_MT_POSITION_X, clamp(px, MT_SCREEN_WIDTH));
+        abs(ABS_MT_POSITION_Y, clamp(MT_SCREEN_HEIGHT - py, MT_SCREEN_HEIGHT));
+    }
+
+    void land_one(int f) {
+        abs(ABS_MT_SLOT, f);
+        abs(ABS_MT_TRACKING_ID, tracking_id);
+        tracking_id = (tracking_id + 1) & 0xffff;
+        position(f, x[f], y[f]);
+        abs(ABS_MT_PRESSURE, 80 + noise(20));
+        frame();
+    }
+
+    void lift_one(int f) {
+        abs(ABS_MT_SLOT, f);
+        abs(ABS_MT_TRACKING_ID, -1);
+        frame();
+    }
+
+    // Fingers in a row centered on (cx, cy), spacing pixels apart
+    void place_row(int fingers, int cx, int cy, int spacing) {
+        for (int f = 0; f < fingers; f++) {
+            x[f] = cx + (2 * f - (fingers - 1)) * spacing / 2;
+            y[f] = cy;
+        }
+    }
+
+public:
+    int jitter;                 // Pixels each finger shakes by per frame
+
+    MultiTouch() : tracking_id(1), seed(1), jitter(3) {}
+
+    void set_seed(unsigned int s) { seed = s ? s : 1; }
+
+    // Uniform in [0, n)
+    int pick(int n) {
+        seed = seed * 1103515245 + 12345;
+        return n > 0 ? (int)((seed >> 16) % n) : 0;
+    }
+
+    // Uniform in [-range, range]
+    int noise(int range) {
+        return range > 0 ? pick(2 * range + 1) - range : 0;
+    }
+
+    static int fingers_in_range(int fingers) {
+        return fingers < 1 ? 1 : fingers > MT_MAX_FINGERS ? MT_MAX_FINGERS : fingers;
+    }
+
+    // The frames built so far, clearing them
+    std::vector<input_event> take() {
+        std::vector<input_event> frames;
+        frames.swap(out);
+        return frames;
+    }
+
+    // Fingers resting at (cx, cy), 180 px apart, for frames frames
+    void tap(int fingers, int cx, int cy, int frames = 8) {
+        fingers = fingers_in_range(fingers);
+        place_row(fingers, cx, cy, 180);
+        for (int f = 0; f < fingers; f++) land_one(f);
+        for (int i = 0; i < frames; i++) {
+            for (int f = 0; f < fingers; f++) position(f, x[f] + noise(jitter), y[f] + noise(jitter));
+            frame();
+        }
+        for (int f = 0; f < fingers; f++) lift_one(f);
+    }
+
+    // Fingers moving together by (dx, dy) over frames frames
+    void swipe(int fingers, int cx, int cy, int dx, int dy, int frames = 20) {
+        fingers = fingers_in_range(fingers);
+        if (frames < 1) frames = 1;
+        place_row(fingers, cx, cy, 180);
+        for (int f = 0; f < fingers; f++) land_one(f);
+        for (int i = 1; i <= frames; i++) {
+            for (int f = 0; f < fingers; f++) {
+                position(f, x[f] + dx * i / frames + noise(jitter), y[f] + dy * i / frames + noise(jitter));
+            }
+            frame();
+        }
+        for (int f = 0; f < fingers; f++) lift_one(f);
+    }
+
+    // Fingers on a circle around (cx, cy), its radius going from r1 to r2
+    void pinch(int fingers, int cx, int cy, int r1, int r2, int frames = 20) {
+        fingers = fingers_in_range(fingers);
+        if (fingers < 2) fingers = 2;
+        if (frames < 1) frames = 1;
+        float angle[MT_MAX_FINGERS];
+        for (int f = 0; f < fingers; f++) {
+            angle[f] = 2 * M_PI * f / fingers + noise(10) * M_PI / 180;
+            x[f] = cx + (int)(r1 * cosf(angle[f]));
+            y[f] = cy + (int)(r1 * sinf(angle[f]));
+        }
+        for (int f = 0; f < fingers; f++) land_one(f);
+        for (int i = 1; i <= frames; i++) {
+            float r = r1 + (float)(r2 - r1) * i / frames;
+            for (int f = 0; f < fingers; f++) {
+                position(f, cx + (int)(r * cosf(angle[f])) + noise(jitter), cy + (int)(r * sinf(angle[f])) + noise(jitter));
+            }
+            frame();
+        }
+        for (int f = 0; f < fingers; f++) lift_one(f);
+    }
+
+    // A resting hand: contacts clustered around (cx, cy) that shake hard,
+    // drift, and partly lift and land again
+    void palm(int contacts, int cx, int cy, int frames = 60) {
+        contacts = fingers_in_range(contacts);
+        if (frames < 4) frames = 4;
+        for (int f = 0; f < contacts; f++) {
+            x[f] = cx + noise(60);
+            y[f] = cy + noise(40);
+            land_one(f);
+        }
+        int drift_x = noise(100), drift_y = noise(60);
+        for (int i = 1; i <= frames; i++) {
+            if (i == frames / 2) {
+                for (int f = 0; f < contacts; f += 2) lift_one(f);
+            } else if (i == frames / 2 + 4) {
+                for (int f = 0; f < contacts; f += 2) land_one(f);
+            }
+            for (int f = 0; f < contacts; f++) {
+                position(f, x[f] + drift_x * i / frames + noise(25), y[f] + drift_y * i / frames + noise(25));
+            }
+            frame();
+        }
+        for (int f = 0; f < contacts; f++) lift_one(f);
+    }
+};
+
+#endif  // LAMP_MULTITOUCH_H
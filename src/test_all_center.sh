@@ -1,5 +1,6 @@
 #!/bin/bash
 # Test script to render all components and fonts at screen center
+# Components are centered on their bounding box (render_component center)
 
 LAMP_PIPE="/tmp/elxnk_lamp.pipe"
 CENTER_X=702  # 1404/2
@@ -9,22 +10,22 @@ echo "=== Testing All Components at Screen Center ==="
 
 # Test components
 echo "Testing: R (Resistor)"
-render_component R $CENTER_X $CENTER_Y 1.0
+render_component center R $CENTER_X $CENTER_Y 1.0
 
 sleep 1
 
 echo "Testing: NMOS (Transistor)"
-render_component NMOS $CENTER_X $CENTER_Y 1.0
+render_component center NMOS $CENTER_X $CENTER_Y 1.0
 
 sleep 1
 
 echo "Testing: D (Diode)"
-render_component D $CENTER_X $CENTER_Y 1.0
+render_component center D $CENTER_X $CENTER_Y 1.0
 
 sleep 1
 
 echo "Testing: VDC (Voltage Source)"
-render_component VDC $CENTER_X $CENTER_Y 1.0
+render_component center VDC $CENTER_X $CENTER_Y 1.0
 
 sleep 1
 
@@ -6,6 +6,9 @@
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
 
+# Drawing goes to the running lamp through one persistent pipe descriptor
+. "$SCRIPT_DIR/elxnk_client.sh"
+
 # UI Configuration
 UI_X=1000              # Left edge of UI box
 UI_Y=1400              # Top edge of UI box
@@ -67,26 +70,24 @@ get_total_pages() {
 # Clear UI area
 clear_ui() {
     # Draw a filled rectangle to clear the area (use erase mode in lamp)
-    echo "erase on" | /opt/bin/lamp
-    echo "pen down $UI_X $UI_Y" | /opt/bin/lamp
-    echo "pen move $((UI_X + UI_WIDTH)) $UI_Y" | /opt/bin/lamp
-    echo "pen move $((UI_X + UI_WIDTH)) $((UI_Y + UI_HEIGHT))" | /opt/bin/lamp
-    echo "pen move $UI_X $((UI_Y + UI_HEIGHT))" | /opt/bin/lamp
-    echo "pen move $UI_X $UI_Y" | /opt/bin/lamp
-    echo "pen up" | /opt/bin/lamp
-    echo "erase off" | /opt/bin/lamp
+    elxnk_send "erase on"
+    elxnk_pen down $UI_X $UI_Y
+    elxnk_pen move $((UI_X + UI_WIDTH)) $UI_Y
+    elxnk_pen move $((UI_X + UI_WIDTH)) $((UI_Y + UI_HEIGHT))
+    elxnk_pen move $UI_X $((UI_Y + UI_HEIGHT))
+    elxnk_pen move $UI_X $UI_Y
+    elxnk_pen up
+    elxnk_send "erase off"
 }
 
 # Draw UI border
 draw_border() {
-    {
-        echo "pen down $UI_X $UI_Y"
-        echo "pen move $((UI_X + UI_WIDTH)) $UI_Y"
-        echo "pen move $((UI_X + UI_WIDTH)) $((UI_Y + UI_HEIGHT))"
-        echo "pen move $UI_X $((UI_Y + UI_HEIGHT))"
-        echo "pen move $UI_X $UI_Y"
-        echo "pen up"
-    } | /opt/bin/lamp
+    elxnk_pen down $UI_X $UI_Y
+    elxnk_pen move $((UI_X + UI_WIDTH)) $UI_Y
+    elxnk_pen move $((UI_X + UI_WIDTH)) $((UI_Y + UI_HEIGHT))
+    elxnk_pen move $UI_X $((UI_Y + UI_HEIGHT))
+    elxnk_pen move $UI_X $UI_Y
+    elxnk_pen up
 }
 
 # Draw component list
@@ -102,7 +103,7 @@ draw_list() {
     # Draw page info
     local current_page=$((page + 1))
     local total_pages=$(get_total_pages)
-    bash "$SCRIPT_DIR/font_render.sh" "PG ${current_page}/${total_pages}" $((UI_X + 10)) $((UI_Y + 10)) 0.3 | /opt/bin/lamp
+    elxnk_text $((UI_X + 10)) $((UI_Y + 10)) 0.3 "PG ${current_page} ${total_pages}"
 
     # Draw list items
     for i in $(seq 0 $((ITEMS_PER_PAGE - 1))); do
@@ -112,16 +113,13 @@ draw_list() {
         # Get component name
         local name=$(bash "$SCRIPT_DIR/component_library.sh" get "$index")
 
-        # Highlight if selected
+        # Highlight if selected (no '>' glyph, so mark with a leading dash stroke)
         if [ $index -eq $selected ]; then
-            echo "> " > /tmp/prefix.txt
-        else
-            echo "  " > /tmp/prefix.txt
+            elxnk_pen line $((UI_X + 4)) $((y_offset + 8)) $((UI_X + 8)) $((y_offset + 8))
         fi
 
         # Draw item
-        local text="$(cat /tmp/prefix.txt)$((index + 1)) $name"
-        bash "$SCRIPT_DIR/font_render.sh" "$text" $((UI_X + 10)) "$y_offset" "$TEXT_SCALE" | /opt/bin/lamp
+        elxnk_text $((UI_X + 10)) "$y_offset" "$TEXT_SCALE" "$((index + 1)) $name"
 
         y_offset=$((y_offset + line_height))
     done
@@ -138,7 +136,7 @@ draw_preview() {
     local preview_x=$((UI_X + UI_WIDTH / 2 - 50))
     local preview_y=$((UI_Y + 250))
 
-    bash "$SCRIPT_DIR/component_library.sh" render "$name" "$preview_x" "$preview_y" "$COMPONENT_SCALE" | /opt/bin/lamp
+    elxnk_place "$name" "$preview_x" "$preview_y" "$COMPONENT_SCALE"
 }
 
 # Redraw entire UI
@@ -0,0 +1,252 @@
+// gesture_bench - touch processing cost of genie_lamp's gesture detector
+//
+// Replays a touch trace through two detectors, many times:
+//   map     - touches in std::map/std::set, per-finger-count maps walked
+//             every frame, taps on finger count only, as genie_lamp had it
+//   slots   - gesture_detector.h: fixed slot array, active-slot bitmask,
+//             the compiled gesture table and the timestamp recognizer
+// Both see the same config and events. Heap allocations during replay are
+// counted as well.
+//
+// The trace is a raw event dump recorded on the device (gesture_trace.h).
+// Without one, a synthetic trace of taps, swipes and long presses with
+// jitter is generated, and the gestures the recognizer fires must be
+// exactly the configured ones among those drawn. gesture_replay checks
+// recorded traces against the gestures expected of them.
+//
+// USAGE:
+//   gesture_bench <config> [trace] [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <new>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "gesture_trace.h"
+
+#define MAP_COOLDOWN_FRAMES 30
+
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+static double now_ms() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+// Order-dependent digest of the gestures fired
+struct FireLog {
+    unsigned long fires;
+    unsigned long long sum;
+
+    FireLog() : fires(0), sum(0) {}
+    void add(int kind, int fingers) {
+        fires++;
+        sum = sum * 31 + kind * 16 + fingers;
+    }
+};
+
+// The detector as genie_lamp had it before slot arrays and the gesture
+// table, actions recorded instead of run
+class MapGestureDetector {
+private:
+    struct Touch {
+        int tracking_id;
+        int x;
+        int y;
+        bool active;
+    };
+
+    std::map<int, Touch> touches;
+    int current_slot;
+    Touch pending_update;
+    bool has_pending;
+    std::set<int> active_ids;
+    const std::vector<GestureConfig>& gestures;
+    std::map<int, bool> gesture_fired;
+    std::map<int, int> gesture_cooldown;
+
+public:
+    FireLog log;
+
+    explicit MapGestureDetector(const std::vector<GestureConfig>& g)
+        : current_slot(0), has_pending(false), gestures(g) {
+        pending_update.tracking_id = -1;
+        pending_update.x = 0;
+        pending_update.y = 0;
+        pending_update.active = false;
+    }
+
+    void process_event(const struct input_event& ev) {
+        if (ev.type == EV_ABS) {
+            switch (ev.code) {
+                case ABS_MT_SLOT:
+                    current_slot = ev.value;
+                    break;
+                case ABS_MT_TRACKING_ID:
+                    if (ev.value == -1) {
+                        touches.erase(current_slot);
+                        active_ids.erase(current_slot);
+                    } else {
+                        pending_update.tracking_id = ev.value;
+                        pending_update.active = true;
+                        has_pending = true;
+                        active_ids.insert(current_slot);
+                    }
+                    break;
+                case ABS_MT_POSITION_X:
+                    pending_update.x = ev.value;
+                    has_pending = true;
+                    break;
+                case ABS_MT_POSITION_Y:
+                    pending_update.y = ev.value;
+                    has_pending = true;
+                    break;
+            }
+        } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+            if (has_pending && pending_update.active) {
+                touches[current_slot] = pending_update;
+                pending_update.active = false;
+                has_pending = false;
+            }
+            detect_gestures();
+        }
+    }
+
+    void detect_gestures() {
+        int finger_count = active_ids.size();
+        for (auto& pair : gesture_cooldown) {
+            if (pair.second > 0) pair.second--;
+        }
+        if (finger_count == 0) {
+            gesture_fired.clear();
+        }
+        for (const auto& g : gestures) {
+            if (g.gesture_type == "tap" && g.fingers == finger_count) {
+                if (gesture_cooldown[finger_count] > 0) continue;
+                if (gesture_fired[finger_count]) continue;
+                log.add(GESTURE_TAP, finger_count);
+                gesture_fired[finger_count] = true;
+                gesture_cooldown[finger_count] = MAP_COOLDOWN_FRAMES;
+            }
+        }
+    }
+};
+
+class SlotGestureDetector : public SimpleGestureDetector {
+public:
+    FireLog log;
+
+    void fire(const GestureConfig& g, int finger_count) {
+        log.add(g.kind, finger_count);
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <config> [trace] [iterations]\n", argv[0]);
+        return 1;
+    }
+    int iterations = argc > 3 ? atoi(argv[3]) : 200;
+    if (iterations < 1) iterations = 1;
+
+    std::vector<struct input_event> trace;
+    std::vector<Drawn> drawn;
+    bool synthetic = argc < 3 || strcmp(argv[2], "-") == 0;
+    if (!synthetic) {
+        if (!load_trace(argv[2], trace) || trace.empty()) {
+            fprintf(stderr, "Cannot read trace: %s\n", argv[2]);
+            return 1;
+        }
+    } else {
+        synthetic_trace(trace, drawn);
+    }
+    // Settles held gestures after each pass, as time running on would
+    long long after_trace = event_us(trace.back()) + 10000000;
+
+    SlotGestureDetector slots;
+    slots.load_config(argv[1]);
+    if (slots.get_gesture_count() == 0) {
+        fprintf(stderr, "No gestures in %s\n", argv[1]);
+        return 1;
+    }
+    MapGestureDetector map(slots.get_gestures());
+
+    // Every pass should fire the configured gestures among those drawn. The
+    // synthetic touches all land in the drawing area, outside named regions.
+    FireLog expected;
+    unsigned long per_pass = 0;
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < drawn.size(); i++) {
+            const std::vector<GestureConfig>& configured = slots.get_gestures();
+            for (size_t g = 0; g < configured.size(); g++) {
+                if (configured[g].kind == drawn[i].kind && configured[g].fingers == drawn[i].fingers &&
+                    configured[g].region == 0) {
+                    expected.add(drawn[i].kind, drawn[i].fingers);
+                    break;
+                }
+            }
+        }
+        if (it == 0) per_pass = expected.fires;
+    }
+
+    size_t frames = 0;
+    for (size_t i = 0; i < trace.size(); i++) frames += trace[i].type == EV_SYN && trace[i].code == SYN_REPORT;
+
+    unsigned long before = allocations;
+    double start = now_ms();
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < trace.size(); i++) map.process_event(trace[i]);
+    }
+    double map_ms = now_ms() - start;
+    unsigned long map_allocs = allocations - before;
+
+    before = allocations;
+    start = now_ms();
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < trace.size(); i++) slots.process_event(trace[i]);
+        slots.tick(after_trace);
+    }
+    double slot_ms = now_ms() - start;
+    unsigned long slot_allocs = allocations - before;
+
+    double total = (double)trace.size() * iterations;
+    printf("Trace: %zu events, %zu frames (%s), %d iterations\n", trace.size(), frames,
+           synthetic ? "synthetic" : argv[2], iterations);
+    printf("  %-8s %14s %10s %12s\n", "Detector", "Events/s", "ns/event", "Allocations");
+    printf("  %-8s %14.0f %10.1f %12lu\n", "map", total / (map_ms / 1000.0), map_ms * 1e6 / total, map_allocs);
+    printf("  %-8s %14.0f %10.1f %12lu\n", "slots", total / (slot_ms / 1000.0), slot_ms * 1e6 / total,
+           slot_allocs);
+    printf("  Speedup: %.1fx\n", map_ms / slot_ms);
+
+    printf("  Fired per pass: map %lu, slots %lu\n", map.log.fires / iterations, slots.log.fires / iterations);
+
+    if (synthetic) {
+        if (slots.log.fires != expected.fires || slots.log.sum != expected.sum) {
+            fprintf(stderr, "MISMATCH: recognized %lu gestures, drew %lu configured ones\n", slots.log.fires,
+                    expected.fires);
+            return 1;
+        }
+        printf("  Recognized all %lu configured gestures drawn per pass\n", per_pass);
+    }
+    return 0;
+}
@@ -0,0 +1,441 @@
+// gesture_replay - replay touch traces through genie_lamp's gesture detector
+//
+// Feeds each trace through SimpleGestureDetector exactly as genie_lamp's
+// input loop would, with a mock action sink that records what fires, then:
+//   accuracy - the gestures fired must be those in <name>.expected, in order
+//   speed    - events/s and cost per frame (SYN_REPORT), the best of several
+//              timed runs; with --baseline, a trace whose cost per frame
+//              grew past --tolerance percent fails
+//
+// A trace <name>.trace is a raw touch event dump (gesture_trace.h). If
+// <name>.pen.trace exists it is the stylus recorded alongside, merged by
+// timestamp (record both: cat /dev/input/event1 > name.pen.trace & ...).
+// <name>.expected lists one gesture per line, as "<kind> <fingers>" with
+// the kinds named as in messages (tap, double tap, long press, swipe left,
+// pinch in, ...); # starts a comment. A trace without one is replayed and
+// its gestures printed, to write one from.
+//
+// --generate writes the synthetic corpus (traces and expected gestures) to
+// a directory; recordings from the device go next to them.
+//
+// USAGE:
+//   gesture_replay [--baseline <file>] [--tolerance <pct>] <config> <trace>...
+//   gesture_replay --write-baseline <file> <config> <trace>...
+//   gesture_replay --generate <dir>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "gesture_trace.h"
+
+#define TIMED_RUNS 5
+#define MIN_RUN_NS 50000000.0       // Repeat a trace until a run takes 50 ms
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Mock action sink: records what fires instead of acting on it
+class ReplayDetector : public SimpleGestureDetector {
+public:
+    std::vector<Drawn> fired;
+
+    void fire(const GestureConfig& g, int finger_count) {
+        Drawn d = { g.kind, finger_count };
+        fired.push_back(d);
+    }
+};
+
+// One event of the merged touch and stylus streams
+struct ReplayEvent {
+    struct input_event ev;
+    bool pen;
+};
+
+struct Trace {
+    std::string name;                   // Path without .trace
+    std::vector<ReplayEvent> events;
+    size_t frames;
+    long long end_us;
+};
+
+static bool ends_with(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static bool load_replay(const std::string& path, Trace& trace) {
+    std::vector<struct input_event> touch, pen;
+    if (!load_trace(path.c_str(), touch) || touch.empty()) {
+        fprintf(stderr, "Error: cannot read trace %s\n", path.c_str());
+        return false;
+    }
+    trace.name = path.substr(0, path.size() - strlen(".trace"));
+    load_trace((trace.name + ".pen.trace").c_str(), pen);
+
+    // Merge by timestamp; the stylus goes first on a tie, as it would have
+    // been read in the same wakeup
+    size_t t = 0, p = 0;
+    trace.events.clear();
+    trace.frames = 0;
+    while (t < touch.size() || p < pen.size()) {
+        bool take_pen = p < pen.size() && (t == touch.size() || event_us(pen[p]) <= event_us(touch[t]));
+        ReplayEvent r = { take_pen ? pen[p++] : touch[t++], take_pen };
+        if (!r.pen && r.ev.type == EV_SYN && r.ev.code == SYN_REPORT) trace.frames++;
+        trace.events.push_back(r);
+    }
+    trace.end_us = event_us(trace.events.back().ev);
+    return true;
+}
+
+// Replays one pass; held gestures are settled as time running on would
+static void replay(ReplayDetector& detector, const Trace& trace) {
+    for (size_t i = 0; i < trace.events.size(); i++) {
+        if (trace.events[i].pen) {
+            detector.process_pen_event(trace.events[i].ev);
+        } else {
+            detector.process_event(trace.events[i].ev);
+        }
+    }
+    detector.tick(trace.end_us + 10000000);
+}
+
+static std::string gesture_line(const Drawn& d) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s %d", gesture_kind_name(d.kind), d.fingers);
+    return buf;
+}
+
+static bool parse_gesture_line(const char* line, Drawn& d) {
+    std::string s(line);
+    size_t end = s.find_last_not_of(" \t\r\n");
+    if (end == std::string::npos) return false;
+    s = s.substr(0, end + 1);
+    size_t space = s.rfind(' ');
+    if (space == std::string::npos) return false;
+    std::string label = s.substr(0, space);
+    d.fingers = atoi(s.c_str() + space + 1);
+    for (int k = 0; k < GESTURE_KINDS; k++) {
+        if (label == GESTURE_KIND_NAMES[k].label) {
+            d.kind = (GestureKind)k;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool load_expected(const std::string& path, std::vector<Drawn>& out) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+    char line[128];
+    int number = 0;
+    while (fgets(line, sizeof(line), f)) {
+        number++;
+        const char* p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        Drawn d;
+        if (!parse_gesture_line(p, d)) {
+            fprintf(stderr, "Warning: %s:%d: not a gesture: %s", path.c_str(), number, line);
+            continue;
+        }
+        out.push_back(d);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool save_expected(const std::string& path, const std::vector<Drawn>& gestures, const char* about) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "# %s\n", about);
+    for (size_t i = 0; i < gestures.size(); i++) fprintf(f, "%s\n", gesture_line(gestures[i]).c_str());
+    return fclose(f) == 0;
+}
+
+// Fired against expected: first difference, or true if equal
+static bool check_accuracy(const Trace& trace, const std::vector<Drawn>& fired, const std::vector<Drawn>& expected) {
+    for (size_t i = 0; i < fired.size() || i < expected.size(); i++) {
+        bool same = i < fired.size() && i < expected.size() && fired[i].kind == expected[i].kind &&
+                    fired[i].fingers == expected[i].fingers;
+        if (same) continue;
+        fprintf(stderr, "Error: %s: gesture %zu is %s, expected %s (%zu fired, %zu expected)\n",
+                trace.name.c_str(), i + 1, i < fired.size() ? gesture_line(fired[i]).c_str() : "none",
+                i < expected.size() ? gesture_line(expected[i]).c_str() : "none", fired.size(), expected.size());
+        return false;
+    }
+    return true;
+}
+
+struct Speed {
+    double ns_per_event;
+    double ns_per_frame;
+    double p99_frame_ns;                // Single frames, timed one by one
+    double max_frame_ns;
+};
+
+static Speed measure(const ReplayDetector& loaded, const Trace& trace, size_t expected_fires) {
+    Speed s;
+    int repeat = 1;
+    double best = 0;
+    for (int run = 0; run < TIMED_RUNS; run++) {
+        std::vector<ReplayDetector> detectors(repeat, loaded);
+        for (int r = 0; r < repeat; r++) detectors[r].fired.reserve(expected_fires * 2 + 16);
+        double start = now_ns();
+        for (int r = 0; r < repeat; r++) replay(detectors[r], trace);
+        double per_pass = (now_ns() - start) / repeat;
+        if (run == 0 || per_pass < best) best = per_pass;
+        if (run == 0 && per_pass * repeat < MIN_RUN_NS) {
+            repeat = (int)(MIN_RUN_NS / (per_pass > 1 ? per_pass : 1)) + 1;
+            run = -1;                   // Calibrated; time again at the new count
+        }
+    }
+    s.ns_per_event = best / trace.events.size();
+    s.ns_per_frame = trace.frames ? best / trace.frames : 0;
+
+    // Per frame: everything up to and including each touch SYN_REPORT
+    std::vector<double> frames;
+    frames.reserve(trace.frames);
+    ReplayDetector detector = loaded;
+    detector.fired.reserve(expected_fires * 2 + 16);
+    double start = now_ns();
+    for (size_t i = 0; i < trace.events.size(); i++) {
+        const ReplayEvent& r = trace.events[i];
+        if (r.pen) {
+            detector.process_pen_event(r.ev);
+            continue;
+        }
+        detector.process_event(r.ev);
+        if (r.ev.type == EV_SYN && r.ev.code == SYN_REPORT) {
+            double end = now_ns();
+            frames.push_back(end - start);
+            start = end;
+        }
+    }
+    std::sort(frames.begin(), frames.end());
+    s.p99_frame_ns = frames.empty() ? 0 : frames[frames.size() * 99 / 100];
+    s.max_frame_ns = frames.empty() ? 0 : frames.back();
+    return s;
+}
+
+// Baseline lines: <trace name> <frames> <ns per frame>
+struct BaselineEntry {
+    size_t frames;
+    double ns_per_frame;
+};
+
+static std::string base_name(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+static bool load_baseline(const char* path, std::map<std::string, BaselineEntry>& baseline) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Error: cannot read replay baseline %s\n", path);
+        return false;
+    }
+    char line[256], name[128];
+    unsigned long frames;
+    double ns;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%127s %lu %lf", name, &frames, &ns) != 3) continue;
+        BaselineEntry& e = baseline[name];
+        e.frames = frames;
+        e.ns_per_frame = ns;
+    }
+    fclose(f);
+    return true;
+}
+
+static bool check_speed(const Trace& trace, const Speed& s, const std::map<std::string, BaselineEntry>& baseline,
+                        double tolerance) {
+    std::map<std::string, BaselineEntry>::const_iterator it = baseline.find(base_name(trace.name));
+    if (it == baseline.end()) {
+        fprintf(stderr, "Note: %s is not in the replay baseline\n", base_name(trace.name).c_str());
+        return true;
+    }
+    const BaselineEntry& base = it->second;
+    if (base.frames != trace.frames) {
+        fprintf(stderr, "Note: %s has %zu frames, baseline %zu; trace changed?\n", base_name(trace.name).c_str(),
+                trace.frames, base.frames);
+    }
+    if (s.ns_per_frame > base.ns_per_frame * (1.0 + tolerance / 100.0)) {
+        fprintf(stderr, "Error: %s takes %.0f ns/frame, baseline %.0f ns/frame (tolerance %.0f%%)\n",
+                base_name(trace.name).c_str(), s.ns_per_frame, base.ns_per_frame, tolerance);
+        fprintf(stderr, "       If intended, take a new baseline: make -C src gesture-baseline\n");
+        return false;
+    }
+    return true;
+}
+
+// The synthetic corpus: what each trace draws
+static bool generate(const std::string& dir) {
+    struct Item {
+        const char* name;
+        const char* about;
+    };
+    static const Item items[] = {
+        { "taps", "Synthetic: taps of 1-5 fingers, a 2-finger double tap" },
+        { "swipes", "Synthetic: swipes in all four directions with 1-3 fingers" },
+        { "pinches", "Synthetic: pinches in and out with 2 and 3 fingers" },
+        { "long_press", "Synthetic: long presses with 1-3 fingers, then a tap" },
+        { "palm", "Synthetic: a jittery palm resting while the pen writes, fires nothing; then a tap" },
+        { "mixed", "Synthetic: taps, swipes and long presses interleaved" },
+    };
+
+    for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        std::vector<struct input_event> touch, pen;
+        std::vector<Drawn> drawn;
+        TraceWriter w(touch, drawn, &pen);
+        std::string name = items[i].name;
+
+        if (name == "taps") {
+            for (int f = 1; f <= 5; f++) w.tap(f);
+            w.double_tap(2);
+            w.tap(2);
+            for (int f = 5; f >= 1; f--) w.tap(f);
+        } else if (name == "swipes") {
+            for (int f = 1; f <= 3; f++) {
+                w.swipe(f, -400, 0, GESTURE_SWIPE_LEFT);
+                w.swipe(f, 400, 0, GESTURE_SWIPE_RIGHT);
+                w.swipe(f, 0, -400, GESTURE_SWIPE_UP);
+                w.swipe(f, 0, 400, GESTURE_SWIPE_DOWN);
+            }
+        } else if (name == "pinches") {
+            for (int f = 2; f <= 3; f++) {
+                w.pinch(f, -0.6f);
+                w.pinch(f, 0.8f);
+            }
+        } else if (name == "long_press") {
+            for (int f = 1; f <= 3; f++) w.long_press(f);
+            w.tap(1);
+        } else if (name == "palm") {
+            w.palm(4);
+            w.palm(3);
+            w.tap(1);
+        } else {
+            synthetic_trace(touch, drawn, 12);
+        }
+
+        std::string base = dir + "/" + name;
+        if (!save_trace((base + ".trace").c_str(), touch) ||
+            (!pen.empty() && !save_trace((base + ".pen.trace").c_str(), pen)) ||
+            !save_expected(base + ".expected", drawn, items[i].about)) {
+            fprintf(stderr, "Error: cannot write %s\n", base.c_str());
+            return false;
+        }
+        printf("%s: %zu events, %zu gestures\n", base.c_str(), touch.size(), drawn.size());
+    }
+    return true;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--baseline <file>] [--tolerance <pct>] <config> <trace>...\n", prog);
+    fprintf(stderr, "       %s --write-baseline <file> <config> <trace>...\n", prog);
+    fprintf(stderr, "       %s --generate <dir>     - Write the synthetic corpus\n", prog);
+}
+
+int main(int argc, char** argv) {
+    const char* baseline_file = NULL;
+    const char* write_baseline = NULL;
+    double tolerance = 0;
+    std::vector<const char*> args;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+            return generate(argv[i + 1]) ? 0 : 1;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_file = argv[++i];
+        } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            write_baseline = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    if (args.size() < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::map<std::string, BaselineEntry> baseline;
+    if (baseline_file && !load_baseline(baseline_file, baseline)) return 1;
+
+    ReplayDetector loaded;
+    loaded.load_config(args[0]);
+    if (loaded.get_gesture_count() == 0) {
+        fprintf(stderr, "No gestures in %s\n", args[0]);
+        return 1;
+    }
+
+    std::string written = "# Gesture replay baseline: touch frames and detector cost per frame\n"
+                          "# (ns, best of several runs) per trace. make gesture-replay BASELINE=<this\n"
+                          "# file> fails when a trace gets slower than this by more than\n"
+                          "# GESTURE_REGRESSION_PCT. Timings are only valid on the host that took them.\n"
+                          "# trace frames ns_per_frame\n";
+    int failures = 0, checked = 0;
+    printf("  %-14s %7s %6s %5s %12s %9s %9s %9s %9s\n", "Trace", "Events", "Frames", "Fired", "Events/s",
+           "ns/event", "ns/frame", "p99", "max");
+
+    for (size_t a = 1; a < args.size(); a++) {
+        std::string path = args[a];
+        if (ends_with(path, ".pen.trace") || !ends_with(path, ".trace")) continue;
+
+        Trace trace;
+        if (!load_replay(path, trace)) {
+            failures++;
+            continue;
+        }
+
+        ReplayDetector detector = loaded;
+        replay(detector, trace);
+
+        std::vector<Drawn> expected;
+        bool have_expected = load_expected(trace.name + ".expected", expected);
+        if (have_expected) {
+            checked++;
+            if (!check_accuracy(trace, detector.fired, expected)) failures++;
+        }
+
+        Speed s = measure(loaded, trace, detector.fired.size());
+        printf("  %-14s %7zu %6zu %5zu %12.0f %9.1f %9.0f %9.0f %9.0f\n", base_name(trace.name).c_str(),
+               trace.events.size(), trace.frames, detector.fired.size(), 1e9 / s.ns_per_event, s.ns_per_event,
+               s.ns_per_frame, s.p99_frame_ns, s.max_frame_ns);
+
+        if (!have_expected) {
+            printf("  No %s.expected; fired:\n", trace.name.c_str());
+            for (size_t i = 0; i < detector.fired.size(); i++) {
+                printf("    %s\n", gesture_line(detector.fired[i]).c_str());
+            }
+        }
+        if (baseline_file && !check_speed(trace, s, baseline, tolerance)) failures++;
+
+        char line[192];
+        snprintf(line, sizeof(line), "%s %zu %.0f\n", base_name(trace.name).c_str(), trace.frames, s.ns_per_frame);
+        written += line;
+    }
+
+    if (write_baseline) {
+        FILE* f = fopen(write_baseline, "w");
+        if (!f || fputs(written.c_str(), f) < 0 || fclose(f) != 0) {
+            fprintf(stderr, "Error: cannot write %s\n", write_baseline);
+            return 1;
+        }
+        printf("Wrote %s\n", write_baseline);
+    }
+
+    if (failures) {
+        fprintf(stderr, "%d trace(s) failed\n", failures);
+        return 1;
+    }
+    printf("  %d trace(s) recognized as expected\n", checked);
+    return 0;
+}
@@ -0,0 +1,283 @@
+// Gesture Trace - touch event dumps for the gesture tools (host)
+//
+// A trace is a raw dump of a touch device, as recorded on the rM2:
+//   cat /dev/input/event2 > touch.trace     (touch, then Ctrl-C)
+// load_trace() reads it in the device's 32-bit event layout or the host's;
+// save_trace() writes the device layout, so synthetic traces look exactly
+// like recorded ones.
+//
+// TraceWriter synthesizes traces at the digitizer's report rate: fingers
+// land and lift one per frame and jitter while held. Each gesture it draws
+// is listed as Drawn, what the recognizer should fire for it. Stylus
+// contact (BTN_TOUCH) goes to a separate stream, as it comes from its own
+// device.
+
+#ifndef GESTURE_TRACE_H
+#define GESTURE_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "genie_lamp/gesture_detector.h"
+
+// A gesture drawn into a synthetic trace
+struct Drawn {
+    GestureKind kind;
+    int fingers;
+};
+
+// Event layout of the 32-bit device (struct timeval of two 32-bit fields)
+struct DeviceEvent {
+    uint32_t sec;
+    uint32_t usec;
+    uint16_t type;
+    uint16_t code;
+    int32_t value;
+};
+
+// Whether data reads as events of layout E: known types, microseconds in
+// range, time never going back, and ending on a SYN
+template <typename E>
+inline bool plausible(const std::vector<char>& data) {
+    if (data.empty() || data.size() % sizeof(E) != 0) return false;
+    const E* e = (const E*)&data[0];
+    size_t n = data.size() / sizeof(E);
+    long long last = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (e[i].type > EV_MAX || (unsigned long long)e[i].usec >= 1000000) return false;
+        long long t = (long long)e[i].sec * 1000000 + e[i].usec;
+        if (t < last) return false;
+        last = t;
+    }
+    return e[n - 1].type == EV_SYN;
+}
+
+// Host layout, with the field names DeviceEvent uses
+struct HostEvent {
+    long long sec;
+    long long usec;
+    uint16_t type;
+    uint16_t code;
+    int32_t value;
+};
+
+inline bool load_trace(const char* path, std::vector<struct input_event>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<char> data;
+    char buf[16384];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (sizeof(struct input_event) == sizeof(HostEvent) && plausible<HostEvent>(data)) {
+        const struct input_event* e = (const struct input_event*)&data[0];
+        out.assign(e, e + data.size() / sizeof(struct input_event));
+        return true;
+    }
+    if (plausible<DeviceEvent>(data)) {
+        const DeviceEvent* e = (const DeviceEvent*)&data[0];
+        for (size_t i = 0; i < data.size() / sizeof(DeviceEvent); i++) {
+            struct input_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.time.tv_sec = e[i].sec;
+            ev.time.tv_usec = e[i].usec;
+            ev.type = e[i].type;
+            ev.code = e[i].code;
+            ev.value = e[i].value;
+            out.push_back(ev);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Write in the device's layout
+inline bool save_trace(const char* path, const std::vector<struct input_event>& events) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    for (size_t i = 0; i < events.size(); i++) {
+        DeviceEvent e;
+        e.sec = (uint32_t)events[i].time.tv_sec;
+        e.usec = (uint32_t)events[i].time.tv_usec;
+        e.type = events[i].type;
+        e.code = events[i].code;
+        e.value = events[i].value;
+        fwrite(&e, sizeof(e), 1, f);
+    }
+    return fclose(f) == 0;
+}
+
+class TraceWriter {
+private:
+    std::vector<struct input_event>& out;
+    std::vector<Drawn>& drawn;
+    std::vector<struct input_event>* pen_out;
+    unsigned long us;
+    unsigned int seed;
+    int tracking_id;
+    int x[MAX_FINGERS], y[MAX_FINGERS];
+
+    static struct input_event event(unsigned long at, int type, int code, int value) {
+        struct input_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.time.tv_sec = at / 1000000;
+        ev.time.tv_usec = at % 1000000;
+        ev.type = type;
+        ev.code = code;
+        ev.value = value;
+        return ev;
+    }
+
+public:
+    // pen receives stylus events, if any are drawn
+    TraceWriter(std::vector<struct input_event>& events, std::vector<Drawn>& gestures,
+                std::vector<struct input_event>* pen = NULL)
+        : out(events), drawn(gestures), pen_out(pen), us(0), seed(1), tracking_id(1) {}
+
+    unsigned long end_us() const { return us; }
+
+    int jitter(int range) {
+        seed = seed * 1103515245 + 12345;
+        return (int)((seed >> 16) % (2 * range + 1)) - range;
+    }
+
+    void emit(int type, int code, int value) {
+        out.push_back(event(us, type, code, value));
+    }
+
+    void sync() {
+        emit(EV_SYN, SYN_REPORT, 0);
+        us += 7000;
+    }
+
+    // Touch coordinates: the device's Y axis runs bottom to top
+    void position(int f, int px, int py) {
+        emit(EV_ABS, ABS_MT_SLOT, f);
+        emit(EV_ABS, ABS_MT_POSITION_X, px);
+        emit(EV_ABS, ABS_MT_POSITION_Y, SCREEN_HEIGHT - py);
+    }
+
+    void land(int fingers, int spacing = 180) {
+        for (int f = 0; f < fingers; f++) {
+            x[f] = 300 + f * spacing + jitter(40);
+            y[f] = 900 + jitter(200);
+            emit(EV_ABS, ABS_MT_SLOT, f);
+            emit(EV_ABS, ABS_MT_TRACKING_ID, tracking_id++);
+            position(f, x[f], y[f]);
+            emit(EV_ABS, ABS_MT_PRESSURE, 80 + jitter(20));
+            sync();
+        }
+    }
+
+    // Held in place, or moved (dx, dy) in total
+    void hold(int fingers, int frames, int dx, int dy, int shake = 3) {
+        for (int frame = 1; frame <= frames; frame++) {
+            for (int f = 0; f < fingers; f++) {
+                position(f, x[f] + dx * frame / frames + jitter(shake), y[f] + dy * frame / frames + jitter(shake));
+            }
+            sync();
+        }
+    }
+
+    // Fingers move away from their center by scale (negative: toward it)
+    void spread(int fingers, int frames, float scale) {
+        int cx = 0, cy = 0;
+        for (int f = 0; f < fingers; f++) {
+            cx += x[f];
+            cy += y[f];
+        }
+        cx /= fingers;
+        cy /= fingers;
+        for (int frame = 1; frame <= frames; frame++) {
+            float s = scale * frame / frames;
+            for (int f = 0; f < fingers; f++) {
+                position(f, x[f] + (int)((x[f] - cx) * s) + jitter(3), y[f] + (int)((y[f] - cy) * s) + jitter(3));
+            }
+            sync();
+        }
+    }
+
+    void lift(int fingers, unsigned long pause_us = 400000) {
+        for (int f = 0; f < fingers; f++) {
+            emit(EV_ABS, ABS_MT_SLOT, f);
+            emit(EV_ABS, ABS_MT_TRACKING_ID, -1);
+            sync();
+        }
+        us += pause_us;
+    }
+
+    void pen(bool down) {
+        if (!pen_out) return;
+        pen_out->push_back(event(us, EV_KEY, BTN_TOUCH, down ? 1 : 0));
+        pen_out->push_back(event(us, EV_SYN, SYN_REPORT, 0));
+    }
+
+    void tap(int fingers) {
+        land(fingers);
+        hold(fingers, 8, 0, 0);
+        lift(fingers);
+        drawn.push_back((Drawn){ GESTURE_TAP, fingers });
+    }
+
+    void double_tap(int fingers) {
+        land(fingers);
+        hold(fingers, 8, 0, 0);
+        lift(fingers, 120000);
+        land(fingers);
+        hold(fingers, 8, 0, 0);
+        lift(fingers);
+        drawn.push_back((Drawn){ GESTURE_DOUBLE_TAP, fingers });
+    }
+
+    void swipe(int fingers, int dx, int dy, GestureKind kind) {
+        land(fingers);
+        hold(fingers, 20, dx, dy);
+        lift(fingers);
+        drawn.push_back((Drawn){ kind, fingers });
+    }
+
+    void pinch(int fingers, float scale) {
+        land(fingers, 400);
+        spread(fingers, 20, scale);
+        lift(fingers);
+        drawn.push_back((Drawn){ scale < 0 ? GESTURE_PINCH_IN : GESTURE_PINCH_OUT, fingers });
+    }
+
+    void long_press(int fingers) {
+        land(fingers);
+        hold(fingers, 120, 0, 0);       // 840 ms
+        lift(fingers);
+        drawn.push_back((Drawn){ GESTURE_LONG_PRESS, fingers });
+    }
+
+    // A hand resting and shifting while the pen writes: contacts close
+    // together, shaking, some lifting and landing again. Fires nothing.
+    void palm(int contacts) {
+        pen(true);
+        us += 30000;
+        land(contacts, 60);
+        hold(contacts, 40, 120, 60, 25);
+        lift(contacts / 2, 0);
+        hold(contacts, 20, -80, 0, 25);         // Lifted slots stay up
+        lift(contacts, 50000);
+        pen(false);
+        us += 400000;
+    }
+};
+
+// Taps of 1-5 fingers, swipes and long presses, rounds times
+inline unsigned long synthetic_trace(std::vector<struct input_event>& out, std::vector<Drawn>& drawn,
+                                     int rounds = 200) {
+    TraceWriter w(out, drawn);
+    for (int round = 0; round < rounds; round++) {
+        w.tap(1 + round % 5);
+        if (round % 2 == 0) w.swipe(2, -400, 0, GESTURE_SWIPE_LEFT);
+        if (round % 2 == 1) w.swipe(2, 0, 400, GESTURE_SWIPE_DOWN);
+        if (round % 10 == 0) w.long_press(1);
+    }
+    return w.end_us();
+}
+
+#endif  // GESTURE_TRACE_H
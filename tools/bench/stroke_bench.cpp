@@ -0,0 +1,226 @@
+// stroke_bench - decode throughput of packed strokes vs the string form
+//
+// Converts the asset SVGs with svgc's pipeline, then renders every level and
+// orientation of every asset through the render engine many times:
+//   text    - "pen move X Y" strings parsed per command, as the embedded
+//             library stored them before packing
+//   packed  - stroke_codec.h streams decoded with render_strokes()
+// Both feed the same counting sink, and their checksums must match.
+//
+// USAGE:
+//   stroke_bench <components_dir> <fonts_dir> [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../svgc/svg_parser.h"
+#include "../svgc/stroke_levels.h"
+#include "elxnk/renderer.h"
+
+using namespace svgc;
+
+static double now_ms() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static bool read_file(const std::string& path, std::string& data) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buf[16384];
+    size_t n;
+    data.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+// Sums everything it receives so neither path can be optimized away
+class CountingSink : public elxnk::StrokeSink {
+public:
+    unsigned long long sum;
+    unsigned long long ops;
+
+    CountingSink() : sum(0), ops(0) {}
+    void down(int x, int y) { sum += x * 3 + y; ops++; }
+    void move(int x, int y) { sum += x * 5 + y; ops++; }
+    void up() { sum += 7; ops++; }
+    void circle(int cx, int cy, int r1, int r2) { sum += cx + cy + r1 + r2; ops++; }
+    void raw(const char* cmd) { sum += strlen(cmd); ops++; }
+};
+
+// The string-form decoder the renderer used before packing
+static void emit_text_command(elxnk::StrokeSink& sink, const char* cmd, const elxnk::Placement& p) {
+    int a, b, c, d;
+    int ox, oy;
+
+    if (strncmp(cmd, "pen down ", 9) == 0 && sscanf(cmd + 9, "%d %d", &a, &b) == 2) {
+        p.map(a, b, ox, oy);
+        sink.down(ox, oy);
+    } else if (strncmp(cmd, "pen move ", 9) == 0 && sscanf(cmd + 9, "%d %d", &a, &b) == 2) {
+        p.map(a, b, ox, oy);
+        sink.move(ox, oy);
+    } else if (strcmp(cmd, "pen up") == 0) {
+        sink.up();
+    } else if (strncmp(cmd, "pen circle ", 11) == 0 &&
+               sscanf(cmd + 11, "%d %d %d %d", &a, &b, &c, &d) == 4) {
+        p.map(a, b, ox, oy);
+        sink.circle(ox, oy, p.tr(c), p.tr(d));
+    } else {
+        sink.raw(cmd);
+    }
+}
+
+// One variant in both forms
+struct Variant {
+    std::vector<const char*> text;
+    size_t offset;      // Into the asset's packed data
+    size_t size;
+    int count;
+};
+
+struct BenchAsset {
+    std::vector<std::string> strings;   // Owns the text commands
+    std::vector<uint8_t> packed;        // All variants, contiguous
+    std::vector<Variant> variants;
+};
+
+static void add_asset(const Asset& a, std::vector<BenchAsset>& out) {
+    out.push_back(BenchAsset());
+    BenchAsset& b = out.back();
+
+    int orientations = a.glyph ? 1 : ORIENTATIONS;
+    size_t total = 0;
+    for (int lod = 0; lod < LOD_LEVELS; lod++) {
+        for (int o = 0; o < orientations; o++) total += a.variant(lod, o).size();
+    }
+    b.strings.reserve(total);
+
+    for (int lod = 0; lod < LOD_LEVELS; lod++) {
+        for (int o = 0; o < orientations; o++) {
+            const CmdList& cmds = a.variant(lod, o);
+            Variant v;
+            v.offset = b.packed.size();
+            v.count = (int)cmds.size();
+
+            elxnk::StrokeEncoder enc(b.packed);
+            for (size_t i = 0; i < cmds.size(); i++) {
+                const Cmd& c = cmds[i];
+                if (c.op == CMD_DOWN) enc.down(c.a, c.b);
+                else if (c.op == CMD_MOVE) enc.move(c.a, c.b);
+                else if (c.op == CMD_UP) enc.up();
+                else if (c.op == CMD_CIRCLE) enc.circle(c.a, c.b, c.c, c.d);
+                b.strings.push_back(c.text());
+                v.text.push_back(b.strings.back().c_str());
+            }
+            v.size = b.packed.size() - v.offset;
+            b.variants.push_back(v);
+        }
+    }
+}
+
+static void load_dir(const std::string& dir, bool glyph, std::vector<BenchAsset>& out) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    std::vector<std::string> names;
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL) {
+        size_t len = strlen(e->d_name);
+        if (len > 4 && strcmp(e->d_name + len - 4, ".svg") == 0 && strcmp(e->d_name, "Library.svg") != 0) {
+            names.push_back(e->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string svg;
+        Asset a;
+        a.name = names[i].substr(0, names[i].size() - 4);
+        a.glyph = glyph;
+        if (!read_file(dir + "/" + names[i], svg) || !SvgDocument::convert(svg, a.cmds, a.error) || a.cmds.empty()) {
+            continue;
+        }
+        a.build();
+        add_asset(a, out);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <components_dir> <fonts_dir> [iterations]\n", argv[0]);
+        return 1;
+    }
+    int iterations = argc > 3 ? atoi(argv[3]) : 200;
+    if (iterations < 1) iterations = 1;
+
+    std::vector<BenchAsset> assets;
+    load_dir(argv[1], false, assets);
+    load_dir(argv[2], true, assets);
+
+    size_t commands = 0, text_bytes = 0, packed_bytes = 0;
+    for (size_t i = 0; i < assets.size(); i++) {
+        packed_bytes += assets[i].packed.size();
+        for (size_t k = 0; k < assets[i].strings.size(); k++) {
+            text_bytes += assets[i].strings[k].size() + 1 + sizeof(const char*);
+        }
+        commands += assets[i].strings.size();
+    }
+    if (!commands) {
+        fprintf(stderr, "No assets found\n");
+        return 1;
+    }
+
+    // Scaled placement so both paths do the same transform work
+    elxnk::Placement p(700, 900, 1.5f);
+
+    CountingSink text_sink;
+    double start = now_ms();
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < assets.size(); i++) {
+            const BenchAsset& a = assets[i];
+            for (size_t v = 0; v < a.variants.size(); v++) {
+                const Variant& var = a.variants[v];
+                for (int k = 0; k < var.count; k++) emit_text_command(text_sink, var.text[k], p);
+            }
+        }
+    }
+    double text_ms = now_ms() - start;
+
+    CountingSink packed_sink;
+    start = now_ms();
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < assets.size(); i++) {
+            const BenchAsset& a = assets[i];
+            for (size_t v = 0; v < a.variants.size(); v++) {
+                const Variant& var = a.variants[v];
+                elxnk::render_strokes(packed_sink, &a.packed[var.offset], var.size, var.count, p);
+            }
+        }
+    }
+    double packed_ms = now_ms() - start;
+
+    double total = (double)commands * iterations;
+    printf("Assets: %zu, commands: %zu (all levels and orientations), %d iterations\n",
+           assets.size(), commands, iterations);
+    printf("  %-8s %10s %14s %10s\n", "Form", "Bytes", "Commands/s", "ns/cmd");
+    printf("  %-8s %10zu %14.0f %10.1f\n", "text", text_bytes, total / (text_ms / 1000.0),
+           text_ms * 1e6 / total);
+    printf("  %-8s %10zu %14.0f %10.1f\n", "packed", packed_bytes, total / (packed_ms / 1000.0),
+           packed_ms * 1e6 / total);
+    printf("  Speedup: %.1fx, size: %.0f%% of text\n", text_ms / packed_ms, 100.0 * packed_bytes / text_bytes);
+
+    if (text_sink.sum != packed_sink.sum || text_sink.ops != packed_sink.ops) {
+        fprintf(stderr, "MISMATCH: text %llu/%llu, packed %llu/%llu\n",
+                text_sink.ops, text_sink.sum, packed_sink.ops, packed_sink.sum);
+        return 1;
+    }
+    printf("  Output identical (%llu commands)\n", packed_sink.ops);
+    return 0;
+}
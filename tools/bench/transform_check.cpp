@@ -0,0 +1,199 @@
+// transform_check - placement transforms that must draw the same strokes
+//
+// Loads a library file and renders every component through handle_request()
+// with transforms that spell the same orientation differently: a variant
+// name, rot<deg> at a multiple of 90, and the matching matrix. Their strokes
+// must be identical. Angles just off a quarter turn use the affine fallback,
+// which must stay anchored like the variant next to it (within ANCHOR_SLACK).
+// Malformed requests, trailing text and matrices that would distort circles
+// must be refused.
+//
+// USAGE:
+//   transform_check <library.elxl>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "elxnk/renderer.h"
+
+// Largest distance between a near-quarter-turn point and its variant (px)
+#define ANCHOR_SLACK 2
+
+// The embedded library is cross-compiled; only the library file is drawn
+namespace elxnk {
+const Component* find_component(const std::string&) { return NULL; }
+const FontGlyph* find_glyph(char) { return NULL; }
+}
+
+struct Op {
+    char kind;
+    int v[4];
+};
+
+// Keeps everything a placement draws
+class RecordingSink : public elxnk::StrokeSink {
+public:
+    std::vector<Op> ops;
+
+    void add(char kind, int a, int b, int c, int d) {
+        Op op = {kind, {a, b, c, d}};
+        ops.push_back(op);
+    }
+    void down(int x, int y) { add('d', x, y, 0, 0); }
+    void move(int x, int y) { add('m', x, y, 0, 0); }
+    void up() { add('u', 0, 0, 0, 0); }
+    void circle(int cx, int cy, int r1, int r2) { add('c', cx, cy, r1, r2); }
+    void raw(const char* cmd) { add('r', (int)strlen(cmd), 0, 0, 0); }
+};
+
+// Transforms in one group must draw exactly what the first one draws
+static const char* const SAME[][6] = {
+    {"1.0", "1.0 rot0", "1.0 rot360", "1.0 rot-0.0", "1.0 matrix 1 0 0 1", NULL},
+    {"1.0 rot90", "1.0 rot90.0", "1.0 rot450", "1.0 rot-270", "1.0 matrix 0 -1 1 0", NULL},
+    {"1.0 rot180", "1.0 rot180.0", "1.0 rot-180", "1.0 matrix -1 0 0 -1", NULL},
+    {"1.0 rot270", "1.0 rot270.0", "1.0 rot-90", "1.0 matrix 0 1 -1 0", NULL},
+    {"1.0 mirror", "1.0 matrix -1 0 0 1", NULL},
+    {"1.0 mirror90", "1.0 matrix 0 -1 -1 0", NULL},
+    {"1.0 mirror180", "1.0 matrix 1 0 0 -1", NULL},
+    {"1.0 mirror270", "1.0 matrix 0 1 1 0", NULL},
+    {"2.0 rot90", "2.0 rot90.0", "1.0 matrix 0 -2 2 0", "2.0 matrix 0 -1 1 0", NULL},
+};
+
+// Affine angles and the variant each must stay close to
+static const char* const NEAR[][2] = {
+    {"1.0 rot89.99", "1.0 rot90"},
+    {"1.0 rot0.01", "1.0 rot0"},
+    {"1.0 rot180.01", "1.0 rot180"},
+    {"2.0 rot269.99", "2.0 rot270"},
+};
+
+// Requests that must be refused, %s is the component name
+static const char* const REJECT[] = {
+    "place %s 1 2 1.0 rot90 garbage",
+    "place %s 1 2 rot90 garbage",
+    "place %s 1 2 1.0 mirror 0",
+    "place %s 1 2 1.0 matrix 0 -1 1 0 extra",
+    "place %s 1 2 1.0 matrix 0 -1 1",
+    "place %s 1 2 1.0 matrix 0 -1 1 x",
+    "place %s 1 2 1.0 matrix 2 0 0 1",
+    "place %s 1 2 1.0 matrix 1 1 0 1",
+    "place %s 1 2 1.0 matrix 0 0 0 0",
+    "place %s 1 2 1.0 rot90x",
+    "place %s 1 2 1.0 rot",
+};
+
+// Affine requests that must be accepted
+static const char* const ACCEPT[] = {
+    "place %s 1 2 1.0 matrix 0.866 -0.5 0.5 0.866 ",
+    "place %s 1 2 2.0 matrix -0.6 0.8 0.8 0.6",
+    "place %s 1 2 1.0 rot37\t",
+};
+
+static bool place(const char* name, const char* transform, RecordingSink& sink) {
+    char line[160];
+    char err[128];
+    snprintf(line, sizeof(line), "place %s 500 500 %s", name, transform);
+    if (elxnk::handle_request(sink, line, err, sizeof(err)) != elxnk::REQUEST_OK) {
+        printf("FAIL %s: '%s': %s\n", name, line, err);
+        return false;
+    }
+    return true;
+}
+
+static bool same_ops(const char* name, const char* a, const RecordingSink& sa,
+                     const char* b, const RecordingSink& sb, int slack) {
+    if (sa.ops.size() != sb.ops.size()) {
+        printf("FAIL %s: '%s' draws %zu commands, '%s' %zu\n",
+               name, b, sb.ops.size(), a, sa.ops.size());
+        return false;
+    }
+    for (size_t i = 0; i < sa.ops.size(); i++) {
+        const Op& x = sa.ops[i];
+        const Op& y = sb.ops[i];
+        bool ok = x.kind == y.kind;
+        for (int k = 0; ok && k < 4; k++) ok = abs(x.v[k] - y.v[k]) <= slack;
+        if (!ok) {
+            printf("FAIL %s: command %zu of '%s' is %c %d %d %d %d, '%s' has %c %d %d %d %d\n",
+                   name, i, b, y.kind, y.v[0], y.v[1], y.v[2], y.v[3],
+                   a, x.kind, x.v[0], x.v[1], x.v[2], x.v[3]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <library.elxl>\n", argv[0]);
+        return 2;
+    }
+    if (!elxnk::library().load(argv[1]) || elxnk::library().get_file_count() == 0) {
+        fprintf(stderr, "Cannot load %s\n", argv[1]);
+        return 2;
+    }
+
+    const elxnk::LibraryFile& file = elxnk::library().get_file(0);
+    int components = 0;
+    int checks = 0;
+    int failures = 0;
+
+    for (int i = 0; i < file.get_entry_count(); i++) {
+        const elxnk::LibraryEntry& e = file.get_entry(i);
+        if (e.kind != elxnk::LIBRARY_COMPONENT) continue;
+        components++;
+
+        for (size_t g = 0; g < sizeof(SAME) / sizeof(SAME[0]); g++) {
+            RecordingSink first;
+            if (!place(e.name, SAME[g][0], first)) {
+                failures++;
+                continue;
+            }
+            for (int k = 1; SAME[g][k]; k++) {
+                RecordingSink other;
+                checks++;
+                if (!place(e.name, SAME[g][k], other) ||
+                    !same_ops(e.name, SAME[g][0], first, SAME[g][k], other, 0)) {
+                    failures++;
+                }
+            }
+        }
+
+        for (size_t r = 0; r < sizeof(REJECT) / sizeof(REJECT[0]); r++) {
+            RecordingSink sink;
+            char line[160];
+            checks++;
+            snprintf(line, sizeof(line), REJECT[r], e.name);
+            if (elxnk::handle_request(sink, line) != elxnk::REQUEST_ERROR || !sink.ops.empty()) {
+                printf("FAIL %s: '%s' was not refused\n", e.name, line);
+                failures++;
+            }
+        }
+
+        for (size_t a = 0; a < sizeof(ACCEPT) / sizeof(ACCEPT[0]); a++) {
+            RecordingSink sink;
+            char line[160];
+            char err[128];
+            checks++;
+            snprintf(line, sizeof(line), ACCEPT[a], e.name);
+            if (elxnk::handle_request(sink, line, err, sizeof(err)) != elxnk::REQUEST_OK) {
+                printf("FAIL %s: '%s': %s\n", e.name, line, err);
+                failures++;
+            }
+        }
+
+        for (size_t n = 0; n < sizeof(NEAR) / sizeof(NEAR[0]); n++) {
+            RecordingSink affine, variant;
+            checks++;
+            if (!place(e.name, NEAR[n][0], affine) || !place(e.name, NEAR[n][1], variant) ||
+                !same_ops(e.name, NEAR[n][1], variant, NEAR[n][0], affine, ANCHOR_SLACK)) {
+                failures++;
+            }
+        }
+    }
+
+    printf("transform_check: %d components, %d checks, %d failed\n",
+           components, checks, failures);
+    return failures ? 1 : 0;
+}
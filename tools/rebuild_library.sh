@@ -1,66 +1,49 @@
 #!/bin/bash
-# Regenerate component_library.h with new converter
+# Regenerate the embedded library sources and the binary library with svgc
 # Usage: ./rebuild_library.sh
+#
+# The embedded library is normally built incrementally by "make library"
+# (one generated source per SVG); this script forces a full regeneration.
 
 set -e
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROJECT_ROOT="$SCRIPT_DIR/.."
 
-CONVERTER="$PROJECT_ROOT/tools/svg_to_lamp_final.py"
+SVGC="$PROJECT_ROOT/build/host/svgc"
 COMPONENTS_DIR="$PROJECT_ROOT/assets/components"
 FONTS_DIR="$PROJECT_ROOT/assets/font"
-OUTPUT_HEADER="$PROJECT_ROOT/src/elxnk/component_library.h"
+GEN_DIR="$PROJECT_ROOT/build/gen"
+OUTPUT_ARCHIVE="$PROJECT_ROOT/build/libelxnk_assets.a"
+OUTPUT_LIBRARY="$PROJECT_ROOT/build/elxnk.elxl"
 
 echo "============================================"
 echo "Rebuilding Component Library"
 echo "============================================"
-echo "Converter: $CONVERTER"
+echo "Compiler: $SVGC"
 echo "Components: $COMPONENTS_DIR"
 echo "Fonts: $FONTS_DIR"
-echo "Output: $OUTPUT_HEADER"
+echo "Output: $GEN_DIR"
+echo "        $OUTPUT_LIBRARY"
 echo ""
 
-# Check dependencies
-if ! python3 -c "import svgpathtools" 2>/dev/null; then
-    echo "ERROR: svgpathtools not installed"
-    echo "Install: pip install svgpathtools"
-    exit 1
-fi
-
-# Check converter exists
-if [ ! -f "$CONVERTER" ]; then
-    echo "ERROR: Converter not found: $CONVERTER"
-    exit 1
-fi
-
-# Backup old header
-if [ -f "$OUTPUT_HEADER" ]; then
-    cp "$OUTPUT_HEADER" "$OUTPUT_HEADER.backup"
-    echo "Backed up existing header to $OUTPUT_HEADER.backup"
-fi
-
-# Generate new header
-echo ""
-echo "Generating header file..."
-python3 "$CONVERTER" --header "$COMPONENTS_DIR" "$FONTS_DIR" "$OUTPUT_HEADER"
+# Drop generated sources and stamps so every asset is regenerated
+rm -rf "$GEN_DIR"
 
-if [ $? -eq 0 ]; then
+echo "Generating library..."
+if make -C "$PROJECT_ROOT/src" library libfile; then
     echo ""
-    echo "✓ SUCCESS: Header file generated"
-    echo "  File: $OUTPUT_HEADER"
-    echo "  Size: $(wc -c < "$OUTPUT_HEADER") bytes"
+    echo "✓ SUCCESS: Library generated"
+    echo "  Sources: $GEN_DIR ($(ls "$GEN_DIR"/components/*.cpp "$GEN_DIR"/font/*.cpp | wc -l) assets)"
+    echo "  Archive: $OUTPUT_ARCHIVE ($(wc -c < "$OUTPUT_ARCHIVE") bytes)"
+    echo "  Binary: $OUTPUT_LIBRARY ($(wc -c < "$OUTPUT_LIBRARY") bytes)"
     echo ""
     echo "Next steps:"
-    echo "  1. Inspect header: less $OUTPUT_HEADER"
-    echo "  2. Rebuild binary: cd src && make"
-    echo "  3. Test locally: python3 $CONVERTER assets/components/R.svg"
+    echo "  1. Inspect one asset: less $GEN_DIR/components/R.cpp"
+    echo "  2. Rebuild binaries: cd src && make"
+    echo "  3. Test one SVG: $SVGC --dump assets/components/R.svg"
 else
     echo ""
-    echo "✗ FAILED: Header generation failed"
-    if [ -f "$OUTPUT_HEADER.backup" ]; then
-        echo "Restoring backup..."
-        mv "$OUTPUT_HEADER.backup" "$OUTPUT_HEADER"
-    fi
+    echo "✗ FAILED: Library generation failed"
     exit 1
 fi
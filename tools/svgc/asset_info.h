@@ -0,0 +1,157 @@
+// Asset Info - geometry metadata computed at build time
+// Part of svgc, the build-time library compiler
+//
+// For every asset: bounding box, stroke and circle counts, and pin anchors.
+// Pins come from marker elements in the SVG (id or class starting with
+// "pin", see SvgDocument) when there are any, each at the center of its
+// marker. Otherwise they are detected as the open ends of leads: points on the
+// bounding box where a straight stroke perpendicular to that edge ends
+// without touching anything else. Detection is a heuristic for plain
+// schematic symbols; markers are authoritative.
+
+#ifndef SVGC_ASSET_INFO_H
+#define SVGC_ASSET_INFO_H
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "svg_parser.h"
+#include "stroke_optimizer.h"
+
+namespace svgc {
+
+struct BBox {
+    int x0, y0, x1, y1;
+    BBox() : x0(0), y0(0), x1(0), y1(0) {}
+};
+
+// Bounding box of all points and circle extents
+inline BBox command_bbox(const CmdList& cmds) {
+    BBox b;
+    bool any = false;
+    for (size_t i = 0; i < cmds.size(); i++) {
+        const Cmd& c = cmds[i];
+        int xs[2], ys[2];
+        int n = 0;
+        if (c.op == CMD_DOWN || c.op == CMD_MOVE) {
+            xs[0] = c.a; ys[0] = c.b; n = 1;
+        } else if (c.op == CMD_CIRCLE) {
+            xs[0] = c.a - c.c; ys[0] = c.b - c.d;
+            xs[1] = c.a + c.c; ys[1] = c.b + c.d;
+            n = 2;
+        }
+        for (int k = 0; k < n; k++) {
+            if (!any) {
+                b.x0 = b.x1 = xs[k];
+                b.y0 = b.y1 = ys[k];
+                any = true;
+            }
+            b.x0 = std::min(b.x0, xs[k]);
+            b.y0 = std::min(b.y0, ys[k]);
+            b.x1 = std::max(b.x1, xs[k]);
+            b.y1 = std::max(b.y1, ys[k]);
+        }
+    }
+    return b;
+}
+
+struct AssetInfo {
+    BBox bbox;
+    int strokes;                    // Pen strokes, circles excluded
+    int circles;
+    bool pins_marked;               // Pins from SVG markers, not detected
+    std::vector<GridPoint> pins;
+
+    AssetInfo() : strokes(0), circles(0), pins_marked(false) {}
+};
+
+// p lies on the outline of a circle/ellipse (within one pixel)
+inline bool on_circle(const GridPoint& p, const Cmd& c) {
+    if (c.c <= 0 || c.d <= 0) return false;
+    double dx = (double)(p.x - c.a) / c.c, dy = (double)(p.y - c.b) / c.d;
+    double r = sqrt(dx * dx + dy * dy);
+    double tol = 1.0 / std::min(c.c, c.d);
+    return fabs(r - 1.0) <= tol;
+}
+
+// p is touched by anything but the segments of stroke `self` ending at vertex `k`
+inline bool touches_other(const std::vector<StrokeItem>& items, size_t self, size_t k,
+                          const GridPoint& p) {
+    for (size_t i = 0; i < items.size(); i++) {
+        const StrokeItem& s = items[i];
+        if (s.is_circle) {
+            if (on_circle(p, s.circle)) return true;
+            continue;
+        }
+        for (size_t j = 1; j < s.pts.size(); j++) {
+            if (i == self && (j == k || j == k + 1)) continue;
+            if (on_segment(p, s.pts[j - 1], s.pts[j])) return true;
+        }
+    }
+    return false;
+}
+
+// A lead ends at p on one edge of the bounding box: the segment from q is
+// perpendicular to that edge. It may reach the opposite edge only along the
+// longer side of the box (a lead drawn straight through a two-pin symbol);
+// across the shorter side it is a plate or bar.
+inline bool lead_end(const GridPoint& p, const GridPoint& q, const BBox& b) {
+    int w = b.x1 - b.x0, h = b.y1 - b.y0;
+    if (p.x == q.x && p.y != q.y) {
+        bool through = h > w;
+        return (p.y == b.y0 && (through || q.y != b.y1)) || (p.y == b.y1 && (through || q.y != b.y0));
+    }
+    if (p.y == q.y && p.x != q.x) {
+        bool through = w > h;
+        return (p.x == b.x0 && (through || q.x != b.x1)) || (p.x == b.x1 && (through || q.x != b.x0));
+    }
+    return false;
+}
+
+// Open lead ends, in drawing order. Leads are often drawn out and back in
+// one stroke, so their far end is a stroke end or a vertex where the stroke
+// turns back on itself.
+inline std::vector<GridPoint> find_open_ends(const CmdList& cmds, const BBox& b) {
+    std::vector<StrokeItem> items = split_strokes(cmds);
+    std::vector<GridPoint> ends;
+
+    for (size_t i = 0; i < items.size(); i++) {
+        const std::vector<GridPoint>& pts = items[i].pts;
+        if (items[i].is_circle || pts.size() < 2) continue;
+        bool closed = pts.front() == pts.back();
+
+        for (size_t k = 0; k < pts.size(); k++) {
+            const GridPoint& p = pts[k];
+            const GridPoint& q = k > 0 ? pts[k - 1] : pts[1];
+            bool end = (k == 0 || k + 1 == pts.size()) && !closed;
+            bool turn = k > 0 && k + 1 < pts.size() && !continues_straight(q, p, pts[k + 1]) &&
+                        on_segment(pts[k + 1], q, p);
+            if (!end && !turn) continue;
+            if (!lead_end(p, q, b) || touches_other(items, i, k, p)) continue;
+            if (std::find(ends.begin(), ends.end(), p) == ends.end()) ends.push_back(p);
+        }
+    }
+    return ends;
+}
+
+inline AssetInfo asset_info(const CmdList& cmds, const std::vector<CmdList>& markers) {
+    AssetInfo info;
+    info.bbox = command_bbox(cmds);
+
+    for (size_t i = 0; i < cmds.size(); i++) {
+        if (cmds[i].op == CMD_DOWN) info.strokes++;
+        else if (cmds[i].op == CMD_CIRCLE) info.circles++;
+    }
+
+    for (size_t i = 0; i < markers.size(); i++) {
+        BBox m = command_bbox(markers[i]);
+        info.pins.push_back(GridPoint((m.x0 + m.x1) / 2, (m.y0 + m.y1) / 2));
+    }
+    info.pins_marked = !info.pins.empty();
+    if (!info.pins_marked) info.pins = find_open_ends(cmds, info.bbox);
+    return info;
+}
+
+}  // namespace svgc
+
+#endif  // SVGC_ASSET_INFO_H
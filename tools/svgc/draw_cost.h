@@ -0,0 +1,127 @@
+// Draw Cost - evdev events and draw time lamp spends on a command list
+// Part of svgc, the build-time library compiler
+//
+// Mirrors the event helpers in src/lamp/main.cpp: every "pen down" writes a
+// pen_down() burst, every "pen move" a pen_down() burst at the current point
+// plus an interpolated pen_move() of move_pts steps, and "pen circle" traces
+// 370 one-degree arcs with move_pts = 10. Keep in sync when lamp changes.
+//
+// Time follows lamp's pacing: write_events() sleeps before writing each
+// SYN_REPORT, 1 ms by default (pen down, pen up), 10 us for placement moves
+// and 2 us while tracing arcs. Sleeps dominate, so the simulated time leaves
+// out the write() calls themselves.
+
+#ifndef SVGC_DRAW_COST_H
+#define SVGC_DRAW_COST_H
+
+#include <math.h>
+#include "svg_parser.h"
+
+namespace svgc {
+
+#define LAMP_DOWN_POINTS 10     // pen_down() pressure points
+#define LAMP_MOVE_POINTS 500    // move_pts
+#define LAMP_ARC_POINTS 10      // move_pts while tracing a circle
+#define LAMP_ARC_STEPS 370      // trace_arc(0, 360): i < a2 + 10
+
+#define LAMP_REPORT_SLEEP_US 1000   // write_events() default
+#define LAMP_MOVE_SLEEP_US 10       // PenSink::move() -> do_pen_move()
+#define LAMP_ARC_SLEEP_US 2         // trace_arc()
+
+inline long lamp_down_events() {
+    return 8 + 3 * LAMP_DOWN_POINTS;
+}
+
+inline long lamp_move_events(int points) {
+    return lamp_down_events() + 1 + 3 * (points + 1);
+}
+
+inline long lamp_up_events() {
+    return 4;
+}
+
+inline long lamp_circle_events() {
+    return lamp_down_events() + LAMP_ARC_STEPS * lamp_move_events(LAMP_ARC_POINTS) + lamp_up_events();
+}
+
+// SYN_REPORTs per helper; write_events() sleeps once per report
+inline long lamp_down_reports() {
+    return 2 + LAMP_DOWN_POINTS;
+}
+
+inline long lamp_move_reports(int points) {
+    return lamp_down_reports() + 1 + (points + 1);
+}
+
+inline long lamp_up_reports() {
+    return 2;
+}
+
+inline long lamp_down_us() {
+    return lamp_down_reports() * LAMP_REPORT_SLEEP_US;
+}
+
+inline long lamp_move_us() {
+    return lamp_move_reports(LAMP_MOVE_POINTS) * LAMP_MOVE_SLEEP_US;
+}
+
+inline long lamp_up_us() {
+    return lamp_up_reports() * LAMP_REPORT_SLEEP_US;
+}
+
+inline long lamp_circle_us() {
+    return lamp_down_us() + LAMP_ARC_STEPS * lamp_move_reports(LAMP_ARC_POINTS) * LAMP_ARC_SLEEP_US +
+           lamp_up_us();
+}
+
+// What one command list costs to draw
+struct DrawStats {
+    int commands;
+    int strokes;        // Pen lifts: strokes plus circles
+    long events;
+    long time_us;       // Simulated draw time under lamp's pacing
+    double travel;      // Pen-up travel between strokes (library pixels)
+
+    DrawStats() : commands(0), strokes(0), events(0), time_us(0), travel(0) {}
+};
+
+inline DrawStats draw_stats(const CmdList& cmds) {
+    DrawStats s;
+    bool have_pos = false;
+    int px = 0, py = 0;
+
+    s.commands = (int)cmds.size();
+    for (size_t i = 0; i < cmds.size(); i++) {
+        const Cmd& c = cmds[i];
+        switch (c.op) {
+        case CMD_DOWN:
+        case CMD_CIRCLE: {
+            // Circles start and end at (cx + r1, cy)
+            int x = c.op == CMD_CIRCLE ? c.a + c.c : c.a;
+            if (have_pos) s.travel += hypot(x - px, c.b - py);
+            s.strokes++;
+            s.events += c.op == CMD_CIRCLE ? lamp_circle_events() : lamp_down_events();
+            s.time_us += c.op == CMD_CIRCLE ? lamp_circle_us() : lamp_down_us();
+            px = x;
+            py = c.b;
+            have_pos = true;
+            break;
+        }
+        case CMD_MOVE:
+            s.events += lamp_move_events(LAMP_MOVE_POINTS);
+            s.time_us += lamp_move_us();
+            px = c.a;
+            py = c.b;
+            break;
+        case CMD_UP:
+            s.events += lamp_up_events();
+            s.time_us += lamp_up_us();
+            break;
+        }
+    }
+    return s;
+}
+
+}  // namespace svgc
+
+#endif  // SVGC_DRAW_COST_H
@@ -0,0 +1,199 @@
+// Stroke Levels - levels of detail and orientation variants
+// Part of svgc, the build-time library compiler
+//
+// The full-detail commands of every asset are first optimized (see
+// stroke_optimizer.h), then simplified into LOD_LEVELS levels with
+// Ramer-Douglas-Peucker at LOD_TOLERANCES, and every level of a component is
+// precomputed in the 8 orthogonal orientations (see elxnk::Orientation). Rotations are exact
+// integer maps that keep the top-left corner of the full-detail bounding box
+// in place, so every variant and level lines up when placed at (x, y).
+
+#ifndef SVGC_STROKE_LEVELS_H
+#define SVGC_STROKE_LEVELS_H
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "svg_parser.h"
+#include "draw_cost.h"
+#include "stroke_optimizer.h"
+#include "asset_info.h"
+
+namespace svgc {
+
+#define LOD_LEVELS 4
+#define ORIENTATIONS 8
+
+// Simplification tolerance per level (library pixels); level 0 is the
+// flattened SVG as parsed
+static const double LOD_TOLERANCES[LOD_LEVELS] = { 0.0, 1.25, 2.5, 5.0 };
+
+// Orientation names and transforms, in the order of elxnk::Orientation
+struct OrientationDef {
+    const char* suffix;
+    bool mirror;
+    int quarter_turns;      // Clockwise on screen (y down)
+};
+
+static const OrientationDef ORIENTATION_DEFS[ORIENTATIONS] = {
+    { "R0", false, 0 }, { "R90", false, 1 }, { "R180", false, 2 }, { "R270", false, 3 },
+    { "MX", true, 0 }, { "MX90", true, 1 }, { "MX180", true, 2 }, { "MX270", true, 3 }
+};
+
+// Rotate/mirror a command list within the given bounding box
+inline CmdList orient_commands(const CmdList& cmds, const OrientationDef& o, const BBox& b) {
+    CmdList result;
+    result.reserve(cmds.size());
+
+    for (size_t i = 0; i < cmds.size(); i++) {
+        Cmd c = cmds[i];
+        if (c.op == CMD_DOWN || c.op == CMD_MOVE || c.op == CMD_CIRCLE) {
+            int x = c.a;
+            if (o.mirror) x = b.x0 + b.x1 - x;
+            int w = b.x1 - b.x0, h = b.y1 - b.y0;
+            int dx = x - b.x0, dy = c.b - b.y0;
+            for (int t = 0; t < o.quarter_turns; t++) {
+                int ndx = h - dy;
+                dy = dx;
+                dx = ndx;
+                std::swap(w, h);
+            }
+            c.a = b.x0 + dx;
+            c.b = b.y0 + dy;
+            if (c.op == CMD_CIRCLE && o.quarter_turns % 2) std::swap(c.c, c.d);
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+inline double segment_distance(const Cmd& p, const Cmd& a, const Cmd& b) {
+    double dx = b.a - a.a, dy = b.b - a.b;
+    double len2 = dx * dx + dy * dy;
+    if (len2 == 0) return hypot(p.a - a.a, p.b - a.b);
+    double t = ((p.a - a.a) * dx + (p.b - a.b) * dy) / len2;
+    t = std::max(0.0, std::min(1.0, t));
+    return hypot(p.a - (a.a + t * dx), p.b - (a.b + t * dy));
+}
+
+// Ramer-Douglas-Peucker over one stroke; marks the points to keep
+inline void rdp_keep(const std::vector<Cmd>& pts, double tol, std::vector<bool>& keep) {
+    keep.assign(pts.size(), false);
+    keep[0] = keep[pts.size() - 1] = true;
+    std::vector<std::pair<size_t, size_t> > stack;
+    stack.push_back(std::make_pair((size_t)0, pts.size() - 1));
+
+    while (!stack.empty()) {
+        size_t first = stack.back().first, last = stack.back().second;
+        stack.pop_back();
+        double dmax = 0;
+        size_t index = 0;
+        for (size_t i = first + 1; i < last; i++) {
+            double d = segment_distance(pts[i], pts[first], pts[last]);
+            if (d > dmax) {
+                dmax = d;
+                index = i;
+            }
+        }
+        if (dmax > tol) {
+            keep[index] = true;
+            stack.push_back(std::make_pair(first, index));
+            stack.push_back(std::make_pair(index, last));
+        }
+    }
+}
+
+// Append the simplified stroke to result and clear it
+inline void flush_stroke(std::vector<Cmd>& stroke, std::vector<bool>& keep, double tol,
+                         CmdList& result, double& error) {
+    if (stroke.empty()) return;
+    if (stroke.size() > 2) rdp_keep(stroke, tol, keep);
+    else keep.assign(stroke.size(), true);
+
+    size_t prev = 0;
+    for (size_t i = 1; i < stroke.size(); i++) {
+        if (!keep[i]) continue;
+        for (size_t j = prev + 1; j < i; j++) {
+            error = std::max(error, segment_distance(stroke[j], stroke[prev], stroke[i]));
+        }
+        prev = i;
+    }
+    for (size_t i = 0; i < stroke.size(); i++) {
+        if (keep[i]) result.push_back(Cmd(i == 0 ? CMD_DOWN : CMD_MOVE, stroke[i].a, stroke[i].b));
+    }
+    stroke.clear();
+}
+
+// Simplify every down/move stroke; error is the largest distance of a
+// full-detail point from the simplified stroke (library pixels)
+inline CmdList simplify_commands(const CmdList& cmds, double tol, double& error) {
+    error = 0;
+    if (tol <= 0) return cmds;
+
+    CmdList result;
+    std::vector<Cmd> stroke;
+    std::vector<bool> keep;
+
+    for (size_t i = 0; i < cmds.size(); i++) {
+        const Cmd& c = cmds[i];
+        if (c.op == CMD_DOWN) {
+            flush_stroke(stroke, keep, tol, result, error);
+            stroke.push_back(c);
+        } else if (c.op == CMD_MOVE && !stroke.empty()) {
+            stroke.push_back(c);
+        } else {
+            flush_stroke(stroke, keep, tol, result, error);
+            result.push_back(c);
+        }
+    }
+    flush_stroke(stroke, keep, tol, result, error);
+    return result;
+}
+
+// One level of detail of an asset
+struct Level {
+    CmdList cmds;
+    double error;
+    DrawStats cost;                     // Same in every orientation
+    CmdList variants[ORIENTATIONS];     // Components only
+};
+
+// Full build-time data of one component or glyph
+struct Asset {
+    std::string name;       // Component name, or glyph file stem
+    bool glyph;
+    CmdList cmds;           // Full detail, R0
+    Level levels[LOD_LEVELS];
+    std::string error;      // Set if the SVG could not be converted
+    DrawStats converted;    // Full detail before and after optimization
+    DrawStats optimized;
+    std::vector<CmdList> markers;   // Pin marker shapes from the SVG
+    AssetInfo info;                 // Geometry of the optimized full detail
+
+    void build() {
+        converted = draw_stats(cmds);
+        cmds = optimize_commands(cmds);
+        optimized = draw_stats(cmds);
+        info = asset_info(cmds, markers);
+
+        const BBox& b = info.bbox;
+        for (int lod = 0; lod < LOD_LEVELS; lod++) {
+            Level& level = levels[lod];
+            level.cmds = simplify_commands(cmds, LOD_TOLERANCES[lod], level.error);
+            level.cost = draw_stats(level.cmds);
+            if (glyph) continue;
+            for (int o = 0; o < ORIENTATIONS; o++) {
+                level.variants[o] = orient_commands(level.cmds, ORIENTATION_DEFS[o], b);
+            }
+        }
+    }
+
+    // Commands of one level and orientation (glyphs only have R0)
+    const CmdList& variant(int lod, int orientation) const {
+        return glyph ? levels[lod].cmds : levels[lod].variants[orientation];
+    }
+};
+
+}  // namespace svgc
+
+#endif  // SVGC_STROKE_LEVELS_H
@@ -0,0 +1,212 @@
+// Stroke Optimizer - lossless cleanup of converted strokes
+// Part of svgc, the build-time library compiler
+//
+// Runs on the full-detail commands of every asset before levels of detail
+// and orientations are built. Every pass keeps the drawn lines identical and
+// only removes work lamp would otherwise do (see draw_cost.h):
+//   1. Drop zero-length moves and repeated circles
+//   2. Merge collinear segments (exact integer test, same direction only)
+//   3. Join strokes that share an endpoint, reversing one if needed, so the
+//      pen stays down through the shared point
+//   4. Drop single-point strokes already covered by another stroke
+//   5. Order strokes nearest-neighbour, entering each from its nearer end,
+//      to cut pen-up travel
+// None of the passes moves a point, so the bounding box is unchanged.
+
+#ifndef SVGC_STROKE_OPTIMIZER_H
+#define SVGC_STROKE_OPTIMIZER_H
+
+#include <algorithm>
+#include <vector>
+#include "svg_parser.h"
+
+namespace svgc {
+
+struct GridPoint {
+    int x, y;
+    GridPoint(int px = 0, int py = 0) : x(px), y(py) {}
+    bool operator==(const GridPoint& o) const { return x == o.x && y == o.y; }
+    bool operator!=(const GridPoint& o) const { return !(*this == o); }
+};
+
+// One pen stroke (down, moves, up) or one circle
+struct StrokeItem {
+    std::vector<GridPoint> pts;     // Strokes only; one point draws a dot
+    Cmd circle;                     // Circles only
+    bool is_circle;
+
+    StrokeItem() : is_circle(false) {}
+    GridPoint first() const { return is_circle ? GridPoint(circle.a + circle.c, circle.b) : pts.front(); }
+    GridPoint last() const { return is_circle ? first() : pts.back(); }
+};
+
+inline long long grid_dist2(const GridPoint& a, const GridPoint& b) {
+    long long dx = a.x - b.x, dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+// b continues the segment a->b in the same direction towards c
+inline bool continues_straight(const GridPoint& a, const GridPoint& b, const GridPoint& c) {
+    long long ux = b.x - a.x, uy = b.y - a.y;
+    long long vx = c.x - b.x, vy = c.y - b.y;
+    return ux * vy - uy * vx == 0 && ux * vx + uy * vy > 0;
+}
+
+// p lies on the segment a-b
+inline bool on_segment(const GridPoint& p, const GridPoint& a, const GridPoint& b) {
+    long long cross = (long long)(b.x - a.x) * (p.y - a.y) - (long long)(b.y - a.y) * (p.x - a.x);
+    if (cross != 0) return false;
+    return p.x >= std::min(a.x, b.x) && p.x <= std::max(a.x, b.x) &&
+           p.y >= std::min(a.y, b.y) && p.y <= std::max(a.y, b.y);
+}
+
+// Append a point, dropping zero-length moves and collinear interior points
+inline void append_point(std::vector<GridPoint>& pts, const GridPoint& p) {
+    if (!pts.empty() && pts.back() == p) return;
+    while (pts.size() >= 2 && continues_straight(pts[pts.size() - 2], pts.back(), p)) pts.pop_back();
+    pts.push_back(p);
+}
+
+inline std::vector<StrokeItem> split_strokes(const CmdList& cmds) {
+    std::vector<StrokeItem> items;
+    bool open = false;
+
+    for (size_t i = 0; i < cmds.size(); i++) {
+        const Cmd& c = cmds[i];
+        if (c.op == CMD_DOWN) {
+            items.push_back(StrokeItem());
+            append_point(items.back().pts, GridPoint(c.a, c.b));
+            open = true;
+        } else if (c.op == CMD_MOVE && open) {
+            append_point(items.back().pts, GridPoint(c.a, c.b));
+        } else if (c.op == CMD_CIRCLE) {
+            bool repeated = false;
+            for (size_t j = 0; j < items.size() && !repeated; j++) {
+                repeated = items[j].is_circle && items[j].circle == c;
+            }
+            if (!repeated) {
+                items.push_back(StrokeItem());
+                items.back().is_circle = true;
+                items.back().circle = c;
+            }
+            open = false;
+        } else {
+            open = false;
+        }
+    }
+    return items;
+}
+
+// Join b onto a where they share an endpoint; false if they don't
+inline bool join_strokes(StrokeItem& a, const StrokeItem& b) {
+    std::vector<GridPoint> tail(b.pts);
+    if (a.last() == b.last()) {
+        std::reverse(tail.begin(), tail.end());
+    } else if (a.first() == b.last()) {
+        std::reverse(a.pts.begin(), a.pts.end());
+        std::reverse(tail.begin(), tail.end());
+    } else if (a.first() == b.first()) {
+        std::reverse(a.pts.begin(), a.pts.end());
+    } else if (a.last() != b.first()) {
+        return false;
+    }
+    for (size_t i = 1; i < tail.size(); i++) append_point(a.pts, tail[i]);
+    return true;
+}
+
+inline void join_shared_endpoints(std::vector<StrokeItem>& items) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < items.size(); i++) {
+            if (items[i].is_circle || items[i].pts.size() < 2) continue;
+            for (size_t j = i + 1; j < items.size(); j++) {
+                if (items[j].is_circle || items[j].pts.size() < 2) continue;
+                if (join_strokes(items[i], items[j])) {
+                    items.erase(items.begin() + j);
+                    changed = true;
+                    j = i;
+                }
+            }
+        }
+    }
+}
+
+inline void drop_covered_dots(std::vector<StrokeItem>& items) {
+    for (size_t i = 0; i < items.size();) {
+        bool covered = false;
+        if (!items[i].is_circle && items[i].pts.size() == 1) {
+            const GridPoint& p = items[i].pts[0];
+            for (size_t j = 0; j < items.size() && !covered; j++) {
+                if (j == i || items[j].is_circle) continue;
+                const std::vector<GridPoint>& q = items[j].pts;
+                if (q.size() == 1) covered = j < i && q[0] == p;
+                for (size_t k = 1; k < q.size() && !covered; k++) covered = on_segment(p, q[k - 1], q[k]);
+            }
+        }
+        if (covered) items.erase(items.begin() + i);
+        else i++;
+    }
+}
+
+// Greedy nearest-neighbour order, starting with the first item as drawn
+inline void order_strokes(std::vector<StrokeItem>& items) {
+    if (items.size() < 3) return;
+    std::vector<StrokeItem> ordered;
+    ordered.reserve(items.size());
+    ordered.push_back(items[0]);
+    items.erase(items.begin());
+
+    while (!items.empty()) {
+        GridPoint pos = ordered.back().last();
+        size_t best = 0;
+        bool reverse = false;
+        long long best_d = -1;
+        for (size_t i = 0; i < items.size(); i++) {
+            long long d = grid_dist2(pos, items[i].first());
+            if (best_d < 0 || d < best_d) {
+                best_d = d;
+                best = i;
+                reverse = false;
+            }
+            d = grid_dist2(pos, items[i].last());
+            if (d < best_d) {
+                best_d = d;
+                best = i;
+                reverse = true;
+            }
+        }
+        if (reverse) std::reverse(items[best].pts.begin(), items[best].pts.end());
+        ordered.push_back(items[best]);
+        items.erase(items.begin() + best);
+    }
+    items.swap(ordered);
+}
+
+inline CmdList emit_strokes(const std::vector<StrokeItem>& items) {
+    CmdList out;
+    for (size_t i = 0; i < items.size(); i++) {
+        const StrokeItem& s = items[i];
+        if (s.is_circle) {
+            out.push_back(s.circle);
+            continue;
+        }
+        out.push_back(Cmd(CMD_DOWN, s.pts[0].x, s.pts[0].y));
+        for (size_t k = 1; k < s.pts.size(); k++) out.push_back(Cmd(CMD_MOVE, s.pts[k].x, s.pts[k].y));
+        if (s.pts.size() == 1) out.push_back(Cmd(CMD_MOVE, s.pts[0].x, s.pts[0].y));
+        out.push_back(Cmd(CMD_UP));
+    }
+    return out;
+}
+
+inline CmdList optimize_commands(const CmdList& cmds) {
+    std::vector<StrokeItem> items = split_strokes(cmds);
+    join_shared_endpoints(items);
+    drop_covered_dots(items);
+    order_strokes(items);
+    return emit_strokes(items);
+}
+
+}  // namespace svgc
+
+#endif  // SVGC_STROKE_OPTIMIZER_H
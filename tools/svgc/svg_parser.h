@@ -0,0 +1,734 @@
+// SVG Parser - SVG elements to lamp pen commands
+// Part of svgc, the build-time library compiler
+//
+// SUPPORTED:
+//   <path d="...">                  - M L H V C S Q T A Z, absolute and relative
+//   <circle> <ellipse>              - pen circle (flattened if rotated or skewed)
+//   <line> <polyline> <polygon> <rect>
+//   transform="..." on any element  - matrix translate scale rotate skewX skewY
+//
+// Anything inside <defs>, <metadata>, <title>, <desc>, <text>, <clipPath>,
+// <mask>, <symbol> or <pattern> is not drawn.
+//
+// TOLERANCE:
+// Coordinates are converted to library pixels (PIXELS_PER_MM per user unit)
+// before curves are flattened, so the flattening tolerance is in the same
+// pixels as the renderer's LOD budget (LOD_MAX_ERROR_PX at scale 1.0). Curves
+// use half of it; rounding to lamp's integer grid takes the other half.
+
+#ifndef SVGC_SVG_PARSER_H
+#define SVGC_SVG_PARSER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+namespace svgc {
+
+// SVG user units (mm) to library pixels
+#define PIXELS_PER_MM 10.0
+
+// Max distance of a flattened curve from the true curve (library pixels)
+#define FLATTEN_TOLERANCE 0.5
+
+// Subdivision limit for one curve segment (2^depth chords)
+#define FLATTEN_MAX_DEPTH 10
+
+// Lamp pen commands, same numbering as elxnk::OpCode
+enum CmdOp {
+    CMD_DOWN = 1,
+    CMD_MOVE,
+    CMD_UP,
+    CMD_CIRCLE
+};
+
+struct Cmd {
+    int op;
+    int a, b, c, d;
+
+    Cmd(int o = CMD_UP, int pa = 0, int pb = 0, int pc = 0, int pd = 0)
+        : op(o), a(pa), b(pb), c(pc), d(pd) {}
+
+    bool operator==(const Cmd& o) const {
+        return op == o.op && a == o.a && b == o.b && c == o.c && d == o.d;
+    }
+    bool operator<(const Cmd& o) const {
+        if (op != o.op) return op < o.op;
+        if (a != o.a) return a < o.a;
+        if (b != o.b) return b < o.b;
+        if (c != o.c) return c < o.c;
+        return d < o.d;
+    }
+
+    // Lamp text form ("pen move 10 20")
+    std::string text() const {
+        char buf[64];
+        switch (op) {
+            case CMD_DOWN: snprintf(buf, sizeof(buf), "pen down %d %d", a, b); break;
+            case CMD_MOVE: snprintf(buf, sizeof(buf), "pen move %d %d", a, b); break;
+            case CMD_CIRCLE: snprintf(buf, sizeof(buf), "pen circle %d %d %d %d", a, b, c, d); break;
+            default: snprintf(buf, sizeof(buf), "pen up"); break;
+        }
+        return buf;
+    }
+};
+
+typedef std::vector<Cmd> CmdList;
+
+// 2D affine transform, SVG order: x' = a*x + c*y + e, y' = b*x + d*y + f
+struct Matrix {
+    double a, b, c, d, e, f;
+
+    Matrix(double pa = 1, double pb = 0, double pc = 0, double pd = 1, double pe = 0, double pf = 0)
+        : a(pa), b(pb), c(pc), d(pd), e(pe), f(pf) {}
+
+    // this * m (m is applied first)
+    Matrix operator*(const Matrix& m) const {
+        return Matrix(a * m.a + c * m.b, b * m.a + d * m.b,
+                      a * m.c + c * m.d, b * m.c + d * m.d,
+                      a * m.e + c * m.f + e, b * m.e + d * m.f + f);
+    }
+
+    void apply(double x, double y, double& ox, double& oy) const {
+        ox = a * x + c * y + e;
+        oy = b * x + d * y + f;
+    }
+
+    double det() const { return a * d - b * c; }
+
+    // Pure scale + translate (circles stay axis-aligned)
+    bool axis_aligned() const { return fabs(b) < 1e-9 && fabs(c) < 1e-9; }
+
+    // Rotation + uniform scale (circles stay circles)
+    bool conformal() const { return fabs(a - d) < 1e-9 && fabs(b + c) < 1e-9; }
+};
+
+struct Point {
+    double x, y;
+    Point(double px = 0, double py = 0) : x(px), y(py) {}
+};
+
+// Reads numbers and flags from path data and attribute lists
+class NumberReader {
+private:
+    const char* p;
+
+    void skip_separators() {
+        while (*p && (isspace((unsigned char)*p) || *p == ',')) p++;
+    }
+
+public:
+    explicit NumberReader(const char* s) : p(s) {}
+
+    bool number(double& v) {
+        skip_separators();
+        char* end;
+        v = strtod(p, &end);
+        if (end == p) return false;
+        p = end;
+        return true;
+    }
+
+    // Arc flags may be written without separators ("a5 5 0 011 0")
+    bool flag(bool& v) {
+        skip_separators();
+        if (*p != '0' && *p != '1') return false;
+        v = *p++ == '1';
+        return true;
+    }
+
+    // Next path command letter, if the next token is one
+    bool command(char& c) {
+        skip_separators();
+        if (!isalpha((unsigned char)*p) || *p == 'e' || *p == 'E') return false;
+        c = *p++;
+        return true;
+    }
+
+    bool at_end() {
+        skip_separators();
+        return *p == '\0';
+    }
+
+    bool at_number() {
+        skip_separators();
+        return *p && (isdigit((unsigned char)*p) || *p == '-' || *p == '+' || *p == '.');
+    }
+
+    const char* rest() const { return p; }
+    void advance(const char* to) { p = to; }
+};
+
+// Parse an SVG transform list ("translate(1,2) rotate(45)")
+inline Matrix parse_transform(const char* s) {
+    Matrix result;
+    const char* p = s;
+
+    while (*p) {
+        while (*p && (isspace((unsigned char)*p) || *p == ',')) p++;
+        const char* name = p;
+        while (isalpha((unsigned char)*p)) p++;
+        size_t name_len = p - name;
+        while (*p && *p != '(') p++;
+        if (*p != '(' || name_len == 0) break;
+        p++;
+
+        double v[6];
+        int n = 0;
+        NumberReader r(p);
+        while (n < 6 && r.number(v[n])) n++;
+        p = r.rest();
+        while (*p && *p != ')') p++;
+        if (*p == ')') p++;
+
+        std::string fn(name, name_len);
+        Matrix m;
+        if (fn == "matrix" && n == 6) {
+            m = Matrix(v[0], v[1], v[2], v[3], v[4], v[5]);
+        } else if (fn == "translate" && n >= 1) {
+            m = Matrix(1, 0, 0, 1, v[0], n > 1 ? v[1] : 0);
+        } else if (fn == "scale" && n >= 1) {
+            m = Matrix(v[0], 0, 0, n > 1 ? v[1] : v[0], 0, 0);
+        } else if (fn == "rotate" && n >= 1) {
+            double rad = v[0] * M_PI / 180.0;
+            Matrix rot(cos(rad), sin(rad), -sin(rad), cos(rad), 0, 0);
+            if (n >= 3) {
+                m = Matrix(1, 0, 0, 1, v[1], v[2]) * rot * Matrix(1, 0, 0, 1, -v[1], -v[2]);
+            } else {
+                m = rot;
+            }
+        } else if (fn == "skewX" && n >= 1) {
+            m = Matrix(1, 0, tan(v[0] * M_PI / 180.0), 1, 0, 0);
+        } else if (fn == "skewY" && n >= 1) {
+            m = Matrix(1, tan(v[0] * M_PI / 180.0), 0, 1, 0, 0);
+        }
+        result = result * m;
+    }
+
+    return result;
+}
+
+// Collects strokes in library pixels and turns them into pen commands
+class StrokeBuilder {
+private:
+    CmdList& out;
+    Matrix m;                   // User units -> library pixels
+    std::vector<Point> stroke;  // Current subpath, library pixels
+
+    static double chord_distance(const Point& p, const Point& a, const Point& b) {
+        double dx = b.x - a.x;
+        double dy = b.y - a.y;
+        double len = sqrt(dx * dx + dy * dy);
+        if (len < 1e-12) return sqrt((p.x - a.x) * (p.x - a.x) + (p.y - a.y) * (p.y - a.y));
+        return fabs((p.x - a.x) * dy - (p.y - a.y) * dx) / len;
+    }
+
+    // Adaptive subdivision until control points are within tolerance of the chord
+    void cubic(const Point& p0, const Point& p1, const Point& p2, const Point& p3, int depth) {
+        if (depth >= FLATTEN_MAX_DEPTH ||
+            (chord_distance(p1, p0, p3) <= FLATTEN_TOLERANCE &&
+             chord_distance(p2, p0, p3) <= FLATTEN_TOLERANCE)) {
+            stroke.push_back(p3);
+            return;
+        }
+
+        Point p01((p0.x + p1.x) / 2, (p0.y + p1.y) / 2);
+        Point p12((p1.x + p2.x) / 2, (p1.y + p2.y) / 2);
+        Point p23((p2.x + p3.x) / 2, (p2.y + p3.y) / 2);
+        Point a((p01.x + p12.x) / 2, (p01.y + p12.y) / 2);
+        Point b((p12.x + p23.x) / 2, (p12.y + p23.y) / 2);
+        Point mid((a.x + b.x) / 2, (a.y + b.y) / 2);
+
+        cubic(p0, p01, a, mid, depth + 1);
+        cubic(mid, b, p23, p3, depth + 1);
+    }
+
+public:
+    StrokeBuilder(CmdList& cmds, const Matrix& user_to_px) : out(cmds), m(user_to_px) {}
+
+    Point map(double x, double y) const {
+        Point p;
+        m.apply(x, y, p.x, p.y);
+        return p;
+    }
+
+    const Matrix& matrix() const { return m; }
+
+    void move_to(double x, double y) {
+        finish();
+        stroke.push_back(map(x, y));
+    }
+
+    void line_to(double x, double y) {
+        stroke.push_back(map(x, y));
+    }
+
+    // Control points in user units
+    void cubic_to(double x1, double y1, double x2, double y2, double x, double y) {
+        if (stroke.empty()) return;
+        cubic(stroke.back(), map(x1, y1), map(x2, y2), map(x, y), 0);
+    }
+
+    void quad_to(double x1, double y1, double x, double y) {
+        if (stroke.empty()) return;
+        Point p0 = stroke.back();
+        Point q = map(x1, y1);
+        Point p3 = map(x, y);
+        Point c1(p0.x + 2.0 / 3.0 * (q.x - p0.x), p0.y + 2.0 / 3.0 * (q.y - p0.y));
+        Point c2(p3.x + 2.0 / 3.0 * (q.x - p3.x), p3.y + 2.0 / 3.0 * (q.y - p3.y));
+        cubic(p0, c1, c2, p3, 0);
+    }
+
+    // SVG elliptical arc from the current user point (x0, y0), as cubic segments
+    void arc_to(double x0, double y0, double rx, double ry, double phi_deg,
+                bool large_arc, bool sweep, double x, double y) {
+        if (x0 == x && y0 == y) return;
+        rx = fabs(rx);
+        ry = fabs(ry);
+        if (rx == 0 || ry == 0) {
+            line_to(x, y);
+            return;
+        }
+
+        // Endpoint to center parameterization (SVG 1.1 appendix F.6)
+        double phi = phi_deg * M_PI / 180.0;
+        double cp = cos(phi), sp = sin(phi);
+        double dx = (x0 - x) / 2, dy = (y0 - y) / 2;
+        double x1p = cp * dx + sp * dy;
+        double y1p = -sp * dx + cp * dy;
+
+        double lambda = (x1p * x1p) / (rx * rx) + (y1p * y1p) / (ry * ry);
+        if (lambda > 1) {
+            rx *= sqrt(lambda);
+            ry *= sqrt(lambda);
+        }
+
+        double num = rx * rx * ry * ry - rx * rx * y1p * y1p - ry * ry * x1p * x1p;
+        double den = rx * rx * y1p * y1p + ry * ry * x1p * x1p;
+        double coef = den > 0 ? sqrt(fmax(0.0, num / den)) : 0;
+        if (large_arc == sweep) coef = -coef;
+        double cxp = coef * rx * y1p / ry;
+        double cyp = -coef * ry * x1p / rx;
+        double cx = cp * cxp - sp * cyp + (x0 + x) / 2;
+        double cy = sp * cxp + cp * cyp + (y0 + y) / 2;
+
+        double t1 = atan2((y1p - cyp) / ry, (x1p - cxp) / rx);
+        double t2 = atan2((-y1p - cyp) / ry, (-x1p - cxp) / rx);
+        double dt = t2 - t1;
+        if (sweep && dt < 0) dt += 2 * M_PI;
+        if (!sweep && dt > 0) dt -= 2 * M_PI;
+
+        // Split into segments of at most 90 degrees, each one cubic
+        int segments = (int)ceil(fabs(dt) / (M_PI / 2) - 1e-9);
+        if (segments < 1) segments = 1;
+        double step = dt / segments;
+        double k = 4.0 / 3.0 * tan(step / 4);
+
+        for (int i = 0; i < segments; i++) {
+            double a0 = t1 + i * step;
+            double a1 = a0 + step;
+            double ex0 = cos(a0), ey0 = sin(a0);
+            double ex1 = cos(a1), ey1 = sin(a1);
+
+            // Unit circle control points, then scale, rotate, translate
+            double ux[3] = { ex0 - k * ey0, ex1 + k * ey1, ex1 };
+            double uy[3] = { ey0 + k * ex0, ey1 - k * ex1, ey1 };
+            double px[3], py[3];
+            for (int j = 0; j < 3; j++) {
+                double ex = ux[j] * rx, ey = uy[j] * ry;
+                px[j] = cp * ex - sp * ey + cx;
+                py[j] = sp * ex + cp * ey + cy;
+            }
+            if (i == segments - 1) {
+                px[2] = x;
+                py[2] = y;
+            }
+            cubic_to(px[0], py[0], px[1], py[1], px[2], py[2]);
+        }
+    }
+
+    // Ellipse centered at (cx, cy) in user units
+    void ellipse(double cx, double cy, double rx, double ry) {
+        finish();
+        if (rx <= 0 || ry <= 0) return;
+
+        Point c = map(cx, cy);
+        if (m.axis_aligned() || (m.conformal() && rx == ry)) {
+            double sx = m.axis_aligned() ? fabs(m.a) : sqrt(fabs(m.det()));
+            double sy = m.axis_aligned() ? fabs(m.d) : sx;
+            out.push_back(Cmd(CMD_CIRCLE, (int)lround(c.x), (int)lround(c.y),
+                              (int)lround(rx * sx), (int)lround(ry * sy)));
+            return;
+        }
+
+        // Rotated or skewed ellipse: four arcs
+        move_to(cx + rx, cy);
+        arc_to(cx + rx, cy, rx, ry, 0, false, true, cx, cy + ry);
+        arc_to(cx, cy + ry, rx, ry, 0, false, true, cx - rx, cy);
+        arc_to(cx - rx, cy, rx, ry, 0, false, true, cx, cy - ry);
+        arc_to(cx, cy - ry, rx, ry, 0, false, true, cx + rx, cy);
+        finish();
+    }
+
+    // Emit the current subpath as down/move.../up on lamp's integer grid
+    void finish() {
+        if (stroke.size() >= 2) {
+            int lx = 0, ly = 0;
+            size_t start = out.size();
+            for (size_t i = 0; i < stroke.size(); i++) {
+                int x = (int)lround(stroke[i].x);
+                int y = (int)lround(stroke[i].y);
+                if (i == 0) {
+                    out.push_back(Cmd(CMD_DOWN, x, y));
+                } else if (x != lx || y != ly) {
+                    out.push_back(Cmd(CMD_MOVE, x, y));
+                }
+                lx = x;
+                ly = y;
+            }
+            // A subpath that rounds to a single point is still drawn as a dot
+            if (out.size() == start + 1) out.push_back(Cmd(CMD_MOVE, lx, ly));
+            out.push_back(Cmd(CMD_UP));
+        }
+        stroke.clear();
+    }
+};
+
+// Parse path data into the builder (user units)
+inline bool parse_path(const char* d, StrokeBuilder& sb) {
+    NumberReader r(d);
+    char cmd = 0;
+    double cx = 0, cy = 0;          // Current point
+    double sx = 0, sy = 0;          // Subpath start
+    double qx = 0, qy = 0;          // Last control point (for S/T)
+    char last = 0;
+
+    while (!r.at_end()) {
+        char c;
+        if (r.command(c)) {
+            cmd = c;
+        } else if (!cmd || !r.at_number()) {
+            return false;           // Garbage in path data
+        }
+
+        bool rel = islower((unsigned char)cmd) != 0;
+        char up = toupper((unsigned char)cmd);
+        double v[7];
+        bool f1, f2;
+
+        switch (up) {
+            case 'M':
+                if (!r.number(v[0]) || !r.number(v[1])) return false;
+                cx = rel ? cx + v[0] : v[0];
+                cy = rel ? cy + v[1] : v[1];
+                sx = cx;
+                sy = cy;
+                sb.move_to(cx, cy);
+                cmd = rel ? 'l' : 'L';   // Further pairs are line-tos
+                break;
+
+            case 'L':
+                if (!r.number(v[0]) || !r.number(v[1])) return false;
+                cx = rel ? cx + v[0] : v[0];
+                cy = rel ? cy + v[1] : v[1];
+                sb.line_to(cx, cy);
+                break;
+
+            case 'H':
+                if (!r.number(v[0])) return false;
+                cx = rel ? cx + v[0] : v[0];
+                sb.line_to(cx, cy);
+                break;
+
+            case 'V':
+                if (!r.number(v[0])) return false;
+                cy = rel ? cy + v[0] : v[0];
+                sb.line_to(cx, cy);
+                break;
+
+            case 'C':
+                for (int i = 0; i < 6; i++) if (!r.number(v[i])) return false;
+                if (rel) for (int i = 0; i < 6; i += 2) { v[i] += cx; v[i + 1] += cy; }
+                sb.cubic_to(v[0], v[1], v[2], v[3], v[4], v[5]);
+                qx = v[2]; qy = v[3];
+                cx = v[4]; cy = v[5];
+                break;
+
+            case 'S':
+                for (int i = 0; i < 4; i++) if (!r.number(v[i])) return false;
+                if (rel) for (int i = 0; i < 4; i += 2) { v[i] += cx; v[i + 1] += cy; }
+                {
+                    bool smooth = last == 'C' || last == 'S';
+                    double x1 = smooth ? 2 * cx - qx : cx;
+                    double y1 = smooth ? 2 * cy - qy : cy;
+                    sb.cubic_to(x1, y1, v[0], v[1], v[2], v[3]);
+                }
+                qx = v[0]; qy = v[1];
+                cx = v[2]; cy = v[3];
+                break;
+
+            case 'Q':
+                for (int i = 0; i < 4; i++) if (!r.number(v[i])) return false;
+                if (rel) for (int i = 0; i < 4; i += 2) { v[i] += cx; v[i + 1] += cy; }
+                sb.quad_to(v[0], v[1], v[2], v[3]);
+                qx = v[0]; qy = v[1];
+                cx = v[2]; cy = v[3];
+                break;
+
+            case 'T':
+                if (!r.number(v[0]) || !r.number(v[1])) return false;
+                if (rel) { v[0] += cx; v[1] += cy; }
+                {
+                    bool smooth = last == 'Q' || last == 'T';
+                    qx = smooth ? 2 * cx - qx : cx;
+                    qy = smooth ? 2 * cy - qy : cy;
+                    sb.quad_to(qx, qy, v[0], v[1]);
+                }
+                cx = v[0]; cy = v[1];
+                break;
+
+            case 'A':
+                if (!r.number(v[0]) || !r.number(v[1]) || !r.number(v[2]) ||
+                    !r.flag(f1) || !r.flag(f2) || !r.number(v[3]) || !r.number(v[4])) {
+                    return false;
+                }
+                if (rel) { v[3] += cx; v[4] += cy; }
+                sb.arc_to(cx, cy, v[0], v[1], v[2], f1, f2, v[3], v[4]);
+                cx = v[3]; cy = v[4];
+                break;
+
+            case 'Z':
+                if (cx != sx || cy != sy) sb.line_to(sx, sy);
+                cx = sx;
+                cy = sy;
+                // Drawing continues from the start point if no M follows
+                sb.move_to(cx, cy);
+                cmd = 0;
+                break;
+
+            default:
+                return false;
+        }
+        last = up;
+    }
+
+    sb.finish();
+    return true;
+}
+
+// Parse a points attribute ("x1,y1 x2,y2 ...")
+inline void parse_points(const char* s, StrokeBuilder& sb, bool close) {
+    NumberReader r(s);
+    double x, y, x0 = 0, y0 = 0;
+    bool first = true;
+    while (r.number(x) && r.number(y)) {
+        if (first) {
+            sb.move_to(x, y);
+            x0 = x;
+            y0 = y;
+            first = false;
+        } else {
+            sb.line_to(x, y);
+        }
+    }
+    if (close && !first) sb.line_to(x0, y0);
+    sb.finish();
+}
+
+// Minimal XML element scanner: enough for Inkscape/KiCad symbol SVGs
+class SvgDocument {
+private:
+    struct Attribute {
+        std::string name;
+        std::string value;
+    };
+
+    struct Frame {
+        std::string tag;
+        Matrix m;
+        bool hidden;
+    };
+
+    static bool hidden_tag(const std::string& tag) {
+        static const char* const names[] = {
+            "defs", "metadata", "title", "desc", "text", "clipPath", "mask",
+            "symbol", "pattern", "sodipodi:namedview", "style", "script", NULL
+        };
+        for (int i = 0; names[i]; i++) {
+            if (tag == names[i]) return true;
+        }
+        return false;
+    }
+
+    static const char* attr(const std::vector<Attribute>& attrs, const char* name) {
+        for (size_t i = 0; i < attrs.size(); i++) {
+            if (attrs[i].name == name) return attrs[i].value.c_str();
+        }
+        return NULL;
+    }
+
+    static double number_attr(const std::vector<Attribute>& attrs, const char* name) {
+        const char* v = attr(attrs, name);
+        return v ? atof(v) : 0.0;
+    }
+
+    static void draw(const std::string& tag, const std::vector<Attribute>& attrs,
+                     const Matrix& m, CmdList& out, std::string& err) {
+        StrokeBuilder sb(out, m);
+
+        if (tag == "path") {
+            const char* d = attr(attrs, "d");
+            if (d && !parse_path(d, sb)) {
+                sb.finish();
+                err = "bad path data";
+            }
+        } else if (tag == "circle") {
+            double r = number_attr(attrs, "r");
+            sb.ellipse(number_attr(attrs, "cx"), number_attr(attrs, "cy"), r, r);
+        } else if (tag == "ellipse") {
+            sb.ellipse(number_attr(attrs, "cx"), number_attr(attrs, "cy"),
+                       number_attr(attrs, "rx"), number_attr(attrs, "ry"));
+        } else if (tag == "line") {
+            sb.move_to(number_attr(attrs, "x1"), number_attr(attrs, "y1"));
+            sb.line_to(number_attr(attrs, "x2"), number_attr(attrs, "y2"));
+            sb.finish();
+        } else if (tag == "polyline" || tag == "polygon") {
+            const char* pts = attr(attrs, "points");
+            if (pts) parse_points(pts, sb, tag == "polygon");
+        } else if (tag == "rect") {
+            // Corner radii are not drawn
+            double x = number_attr(attrs, "x");
+            double y = number_attr(attrs, "y");
+            double w = number_attr(attrs, "width");
+            double h = number_attr(attrs, "height");
+            if (w > 0 && h > 0) {
+                sb.move_to(x, y);
+                sb.line_to(x + w, y);
+                sb.line_to(x + w, y + h);
+                sb.line_to(x, y + h);
+                sb.line_to(x, y);
+                sb.finish();
+            }
+        }
+    }
+
+    // Pin anchor markers: id or class starting with "pin" (pin1, pin_a, ...)
+    static bool pin_marker(const std::vector<Attribute>& attrs) {
+        const char* id = attr(attrs, "id");
+        const char* cls = attr(attrs, "class");
+        return (id && strncmp(id, "pin", 3) == 0) || (cls && strncmp(cls, "pin", 3) == 0);
+    }
+
+public:
+    // Convert SVG text into pen commands. Returns false with err set on
+    // malformed markup; a bad element only skips that element.
+    // Pin markers are not drawn; if markers is given, each one is converted
+    // into its own command list there, in document order.
+    static bool convert(const std::string& svg, CmdList& out, std::string& err,
+                        std::vector<CmdList>* markers = NULL) {
+        std::vector<Frame> stack;
+        Frame root;
+        root.m = Matrix(PIXELS_PER_MM, 0, 0, PIXELS_PER_MM, 0, 0);
+        root.hidden = false;
+        stack.push_back(root);
+
+        const char* p = svg.c_str();
+        while ((p = strchr(p, '<')) != NULL) {
+            if (strncmp(p, "<!--", 4) == 0) {
+                p = strstr(p, "-->");
+                if (!p) break;
+                p += 3;
+                continue;
+            }
+            if (p[1] == '?' || p[1] == '!') {
+                p = strchr(p, '>');
+                if (!p) break;
+                p++;
+                continue;
+            }
+
+            bool closing = p[1] == '/';
+            p += closing ? 2 : 1;
+            const char* name = p;
+            while (*p && !isspace((unsigned char)*p) && *p != '>' && *p != '/') p++;
+            std::string tag(name, p - name);
+
+            if (closing) {
+                if (stack.size() > 1) stack.pop_back();
+                p = strchr(p, '>');
+                if (!p) break;
+                p++;
+                continue;
+            }
+
+            // Attributes
+            std::vector<Attribute> attrs;
+            bool self_closing = false;
+            for (;;) {
+                while (*p && isspace((unsigned char)*p)) p++;
+                if (*p == '\0') {
+                    err = "unterminated tag <" + tag + ">";
+                    return false;
+                }
+                if (*p == '>') { p++; break; }
+                if (*p == '/' && p[1] == '>') { p += 2; self_closing = true; break; }
+
+                const char* an = p;
+                while (*p && *p != '=' && !isspace((unsigned char)*p) && *p != '>') p++;
+                Attribute a;
+                a.name.assign(an, p - an);
+                while (*p && isspace((unsigned char)*p)) p++;
+                if (*p == '=') {
+                    p++;
+                    while (*p && isspace((unsigned char)*p)) p++;
+                    char q = *p;
+                    if (q == '"' || q == '\'') {
+                        const char* end = strchr(p + 1, q);
+                        if (!end) {
+                            err = "unterminated attribute in <" + tag + ">";
+                            return false;
+                        }
+                        a.value.assign(p + 1, end - p - 1);
+                        p = end + 1;
+                    }
+                }
+                if (a.name.empty()) p++;
+                else attrs.push_back(a);
+            }
+
+            Frame frame;
+            frame.tag = tag;
+            frame.hidden = stack.back().hidden || hidden_tag(tag);
+            const char* display = attr(attrs, "display");
+            if (display && strcmp(display, "none") == 0) frame.hidden = true;
+            const char* t = attr(attrs, "transform");
+            frame.m = t ? stack.back().m * parse_transform(t) : stack.back().m;
+
+            bool marker = pin_marker(attrs);
+            if (!frame.hidden && marker) {
+                std::string element_err;
+                CmdList shape;
+                draw(tag, attrs, frame.m, shape, element_err);
+                if (markers && !shape.empty()) markers->push_back(shape);
+            } else if (!frame.hidden) {
+                std::string element_err;
+                draw(tag, attrs, frame.m, out, element_err);
+                if (!element_err.empty()) {
+                    fprintf(stderr, "Warning: <%s>: %s\n", tag.c_str(), element_err.c_str());
+                }
+            }
+
+            if (!self_closing) stack.push_back(frame);
+        }
+
+        return true;
+    }
+};
+
+}  // namespace svgc
+
+#endif  // SVGC_SVG_PARSER_H
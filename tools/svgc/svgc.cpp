@@ -0,0 +1,879 @@
+// svgc - SVG to stroke library compiler
+// Converts component and font SVGs into embedded library sources and binary
+// library files (.elxl).
+//
+// USAGE:
+//   svgc --component <file.svg> <out.cpp>   - One component translation unit
+//   svgc --glyph <file.svg> <out.cpp>       - One font glyph translation unit
+//   svgc --registry <out.cpp> <components_dir> <fonts_dir>
+//                                           - Lookup table over all assets
+//   svgc <components_dir> <fonts_dir> --binary <file.elxl> [-j N]
+//   svgc <components_dir> <fonts_dir> --metadata <out.h> [-j N]
+//                                           - Constexpr geometry tables
+//   svgc <components_dir> <fonts_dir> --write-baseline <costs.txt>
+//                                           - Draw cost baseline of all assets
+//   svgc --dump <file.svg>                  - Print the lamp commands of one SVG
+//
+// Asset and batch modes take cost limits (see draw_cost.h): --budget-ms <ms>
+// fails an asset whose full detail takes longer to draw, --baseline <file>
+// fails one that costs more than the committed baseline by over
+// --tolerance <pct>. Failing assets are not written.
+//
+// Per-asset sources let make rebuild only the SVGs that changed (see
+// src/Makefile). Generated files are only rewritten when their content
+// changes, so dependents are not recompiled needlessly.
+//
+// The binary library and the metadata tables are built in one run: assets are
+// parsed, flattened and simplified on N worker threads (default: all cores)
+// and written afterwards in name order, so output does not depend on the
+// thread count.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "svg_parser.h"
+#include "stroke_levels.h"
+#include "../../src/elxnk/stroke_codec.h"
+
+using namespace svgc;
+
+// Binary library file layout, must match src/elxnk/library_file.h
+#define LIBRARY_MAGIC "ELXL"
+#define LIBRARY_VERSION 2
+#define LIBRARY_HEADER_SIZE 32
+#define LIBRARY_NAME_LEN 16
+#define LIBRARY_ENTRY_SIZE (LIBRARY_NAME_LEN + 4 + 4 * LOD_LEVELS + 8 * LOD_LEVELS * ORIENTATIONS)
+
+enum LibraryKind { LIBRARY_COMPONENT = 0, LIBRARY_GLYPH = 1 };
+
+static double now_ms() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static bool read_file(const std::string& path, std::string& data) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buf[16384];
+    size_t n;
+    data.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+// *.svg files in a directory, sorted by name (missing directory = none)
+static std::vector<std::string> list_svgs(const char* dir) {
+    std::vector<std::string> names;
+    DIR* d = opendir(dir);
+    if (!d) return names;
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL) {
+        size_t len = strlen(e->d_name);
+        if (len > 4 && strcmp(e->d_name + len - 4, ".svg") == 0 && e->d_name[0] != '.') {
+            names.push_back(e->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+struct Job {
+    std::string path;
+    Asset asset;
+};
+
+static void convert(Job& job) {
+    std::string svg;
+    if (!read_file(job.path, svg)) {
+        job.asset.error = "cannot read file";
+        return;
+    }
+    if (!SvgDocument::convert(svg, job.asset.cmds, job.asset.error, &job.asset.markers)) return;
+    job.asset.build();
+}
+
+// Convert all jobs on a pool of threads
+static void run_jobs(std::vector<Job>& jobs, int threads) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+
+    if (threads < 1) threads = 1;
+    if ((size_t)threads > jobs.size()) threads = (int)jobs.size();
+
+    for (int t = 0; t < threads; t++) {
+        pool.push_back(std::thread([&jobs, &next]() {
+            size_t i;
+            while ((i = next++) < jobs.size()) convert(jobs[i]);
+        }));
+    }
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+}
+
+// ---------------------------------------------------------------------------
+// Generated sources
+
+// Write a file only if its content changed, so make sees an unchanged
+// timestamp and does not recompile dependents. Writes are atomic.
+static bool write_if_changed(const std::string& path, const std::string& content) {
+    std::string old;
+    if (read_file(path, old) && old == content) return true;
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path.c_str(), (int)getpid());
+    FILE* f = fopen(tmp, "wb");
+    if (!f || fwrite(content.data(), 1, content.size(), f) != content.size() || fclose(f) != 0) {
+        perror(tmp);
+        unlink(tmp);
+        return false;
+    }
+    if (rename(tmp, path.c_str()) != 0) {
+        perror(path.c_str());
+        unlink(tmp);
+        return false;
+    }
+    return true;
+}
+
+static std::string format(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+static std::string format(const char* fmt, ...) {
+    char buf[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+// C identifier for an asset name ("R_TRIM" -> "R_TRIM", "A-F" -> "A_F")
+static std::string symbol_name(const std::string& stem) {
+    std::string s;
+    for (size_t i = 0; i < stem.size(); i++) {
+        if (stem[i] == '+') s += "plus";
+        else if (isalnum((unsigned char)stem[i])) s += stem[i];
+        else s += '_';
+    }
+    return s;
+}
+
+static std::string asset_symbol(const std::string& stem, bool glyph) {
+    return (glyph ? "glyph_" : "component_") + symbol_name(stem);
+}
+
+static void encode_commands(const CmdList& cmds, std::vector<uint8_t>& out) {
+    elxnk::StrokeEncoder enc(out);
+    for (size_t i = 0; i < cmds.size(); i++) {
+        const Cmd& c = cmds[i];
+        switch (c.op) {
+            case CMD_DOWN: enc.down(c.a, c.b); break;
+            case CMD_MOVE: enc.move(c.a, c.b); break;
+            case CMD_UP: enc.up(); break;
+            case CMD_CIRCLE: enc.circle(c.a, c.b, c.c, c.d); break;
+        }
+    }
+}
+
+// Size of the same commands as "pen ..." string literals plus a pointer
+// each on the 32-bit target, as the library stored them before packing
+static size_t text_size(const CmdList& cmds) {
+    size_t n = 0;
+    for (size_t i = 0; i < cmds.size(); i++) n += cmds[i].text().size() + 1 + 4;
+    return n;
+}
+
+// Every level and orientation of one asset packed back to back; identical
+// variants share one range
+struct PackedAsset {
+    std::vector<uint8_t> data;
+    size_t offset[LOD_LEVELS][ORIENTATIONS];
+    size_t size[LOD_LEVELS][ORIENTATIONS];
+    std::vector<std::string> labels;    // Variant starting at each offset
+    std::vector<size_t> starts;
+    size_t text_bytes;                  // Same variants in string form
+};
+
+static void pack_asset(const Asset& a, PackedAsset& packed) {
+    std::map<CmdList, std::pair<size_t, size_t> > ranges;
+    packed.data.clear();
+    packed.text_bytes = 0;
+
+    for (int lod = 0; lod < LOD_LEVELS; lod++) {
+        int variants = a.glyph ? 1 : ORIENTATIONS;
+        for (int o = 0; o < variants; o++) {
+            const CmdList& v = a.variant(lod, o);
+            std::map<CmdList, std::pair<size_t, size_t> >::iterator it = ranges.find(v);
+            if (it == ranges.end()) {
+                size_t start = packed.data.size();
+                encode_commands(v, packed.data);
+                it = ranges.insert(std::make_pair(v, std::make_pair(start, packed.data.size() - start))).first;
+                std::string label = a.glyph ? "" : std::string(ORIENTATION_DEFS[o].suffix) + " ";
+                packed.labels.push_back(label + format("LOD%d, %zu commands", lod, v.size()));
+                packed.starts.push_back(start);
+                packed.text_bytes += text_size(v);
+            }
+            packed.offset[lod][o] = it->second.first;
+            packed.size[lod][o] = it->second.second;
+        }
+    }
+}
+
+static void byte_array(std::string& out, const std::string& name, const PackedAsset& packed) {
+    out += "static const uint8_t " + name + "[] = {\n";
+    for (size_t v = 0; v < packed.starts.size(); v++) {
+        size_t start = packed.starts[v];
+        size_t end = v + 1 < packed.starts.size() ? packed.starts[v + 1] : packed.data.size();
+        out += "    // " + packed.labels[v] + "\n";
+        for (size_t i = start; i < end; i++) {
+            out += (i - start) % 16 == 0 ? "    " : " ";
+            out += format("0x%02x,", packed.data[i]);
+            if ((i - start) % 16 == 15 || i + 1 == end) out += "\n";
+        }
+    }
+    out += "};\n\n";
+}
+
+static std::string detail(const std::string& array, const PackedAsset& packed, int lod, int o,
+                          size_t count, const Level& level) {
+    return format("{%s + %zu, %zu, %zu, %.2ff, %ld, %ld}", array.c_str(), packed.offset[lod][o],
+                  packed.size[lod][o], count, level.error, level.cost.events, level.cost.time_us);
+}
+
+// One Component or FontGlyph definition with all its strokes in one array
+static std::string asset_source(const Asset& a, const std::string& svg_path) {
+    std::string sym = symbol_name(a.name);
+    std::string array = (a.glyph ? "font_" + sym : sym) + "_strokes";
+    std::string out;
+
+    PackedAsset packed;
+    pack_asset(a, packed);
+
+    out += "// Auto-generated by svgc from " + svg_path + "\n";
+    out += "// DO NOT EDIT MANUALLY - edit the SVG and run make\n\n";
+    out += "#include \"elxnk/component_library.h\"\n\n";
+    out += "namespace elxnk {\n\n";
+
+    out += format("// %zu bytes packed (%zu bytes as strings)\n", packed.data.size(), packed.text_bytes);
+    byte_array(out, array, packed);
+
+    std::string levels;
+    for (int lod = 0; lod < LOD_LEVELS; lod++) {
+        std::string row;
+        int variants = a.glyph ? 1 : ORIENTATIONS;
+        for (int o = 0; o < variants; o++) {
+            if (o) row += ",\n         ";
+            row += detail(array, packed, lod, o, a.variant(lod, o).size(), a.levels[lod]);
+        }
+        if (a.glyph) {
+            levels += "    " + row + ",\n";
+        } else {
+            levels += "        {" + row + "},\n";
+        }
+    }
+
+    std::string obj = asset_symbol(a.name, a.glyph);
+    if (a.glyph) {
+        out += "extern const FontGlyph " + obj + ";\n";
+        out += format("const FontGlyph %s = {'%c', %s, sizeof(%s), %zu, {\n",
+                      obj.c_str(), a.name[0], array.c_str(), array.c_str(), a.cmds.size());
+        out += levels + "}};\n\n";
+    } else {
+        out += "extern const Component " + obj + ";\n";
+        out += format("const Component %s = {\"%s\", %s, sizeof(%s), %zu, {\n",
+                      obj.c_str(), a.name.c_str(), array.c_str(), array.c_str(), a.cmds.size());
+        out += levels + "}};\n\n";
+    }
+
+    out += "}  // namespace elxnk\n";
+    return out;
+}
+
+// Stems of the *.svg files in a directory, in name order
+static std::vector<std::string> list_stems(const char* dir, bool skip_library) {
+    std::vector<std::string> stems;
+    std::vector<std::string> names = list_svgs(dir);
+    for (size_t i = 0; i < names.size(); i++) {
+        if (skip_library && names[i] == "Library.svg") continue;
+        stems.push_back(names[i].substr(0, names[i].size() - 4));
+    }
+    std::sort(stems.begin(), stems.end());
+    return stems;
+}
+
+// Registry of every asset with the lookup functions of component_library.h.
+// Depends only on the set of asset names, not on their content.
+static std::string registry_source(const std::vector<std::string>& components,
+                                   const std::vector<std::string>& glyph_stems) {
+    // One glyph per character; multi-character names use their first character
+    std::vector<std::string> glyphs;
+    std::string seen;
+    for (size_t i = 0; i < glyph_stems.size(); i++) {
+        char c = glyph_stems[i][0];
+        if (seen.find(c) != std::string::npos) {
+            fprintf(stderr, "Warning: glyph %s duplicates '%c', skipped\n", glyph_stems[i].c_str(), c);
+            continue;
+        }
+        seen += c;
+        glyphs.push_back(glyph_stems[i]);
+    }
+    std::sort(glyphs.begin(), glyphs.end(), [](const std::string& x, const std::string& y) {
+        return (unsigned char)x[0] < (unsigned char)y[0];
+    });
+
+    std::string out;
+    out += "// Auto-generated by svgc - asset registry\n";
+    out += "// DO NOT EDIT MANUALLY - regenerated when assets are added or removed\n\n";
+    out += "#include <string.h>\n";
+    out += "#include \"elxnk/component_library.h\"\n\n";
+    out += "namespace elxnk {\n\n";
+
+    for (size_t i = 0; i < components.size(); i++) {
+        out += "extern const Component " + asset_symbol(components[i], false) + ";\n";
+    }
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        out += "extern const FontGlyph " + asset_symbol(glyphs[i], true) + ";\n";
+    }
+
+    out += "\n// Components by name (binary search)\n";
+    out += "static const Component* const COMPONENTS[] = {\n";
+    for (size_t i = 0; i < components.size(); i++) {
+        out += "    &" + asset_symbol(components[i], false) + ",\n";
+    }
+    out += "    NULL\n};\n\n";
+
+    out += "// Glyphs by character\n";
+    out += "static const FontGlyph* const FONT_GLYPHS[] = {\n";
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        out += "    &" + asset_symbol(glyphs[i], true) + ",\n";
+    }
+    out += "    NULL\n};\n\n";
+
+    out += format("static const int COMPONENT_COUNT = %zu;\n", components.size());
+    out += format("static const int GLYPH_COUNT = %zu;\n\n", glyphs.size());
+
+    out +=
+        "const Component* find_component(const std::string& name) {\n"
+        "    int lo = 0, hi = COMPONENT_COUNT - 1;\n"
+        "    while (lo <= hi) {\n"
+        "        int mid = (lo + hi) / 2;\n"
+        "        int c = strcmp(name.c_str(), COMPONENTS[mid]->name);\n"
+        "        if (c == 0) return COMPONENTS[mid];\n"
+        "        if (c < 0) hi = mid - 1;\n"
+        "        else lo = mid + 1;\n"
+        "    }\n"
+        "    return nullptr;\n"
+        "}\n\n"
+        "const FontGlyph* find_glyph(char c) {\n"
+        "    int lo = 0, hi = GLYPH_COUNT - 1;\n"
+        "    while (lo <= hi) {\n"
+        "        int mid = (lo + hi) / 2;\n"
+        "        unsigned char g = FONT_GLYPHS[mid]->character;\n"
+        "        if ((unsigned char)c == g) return FONT_GLYPHS[mid];\n"
+        "        if ((unsigned char)c < g) hi = mid - 1;\n"
+        "        else lo = mid + 1;\n"
+        "    }\n"
+        "    return nullptr;\n"
+        "}\n\n"
+        "int get_component_count() {\n"
+        "    return COMPONENT_COUNT;\n"
+        "}\n\n"
+        "const Component& get_component(int index) {\n"
+        "    return *COMPONENTS[index];\n"
+        "}\n\n"
+        "int get_glyph_count() {\n"
+        "    return GLYPH_COUNT;\n"
+        "}\n\n"
+        "const FontGlyph& get_glyph(int index) {\n"
+        "    return *FONT_GLYPHS[index];\n"
+        "}\n\n"
+        "}  // namespace elxnk\n";
+    return out;
+}
+
+static std::string bounds_literal(const BBox& b) {
+    return format("{%d, %d, %d, %d}", b.x0, b.y0, b.x1, b.y1);
+}
+
+// Constexpr geometry tables for src/elxnk/asset_metadata.h. Components and
+// glyphs are sorted the way the registry sorts them, for binary search.
+static std::string metadata_source(const std::vector<const Asset*>& components,
+                                   const std::vector<const Asset*>& glyph_assets) {
+    std::vector<const Asset*> glyphs;
+    std::string seen;
+    for (size_t i = 0; i < glyph_assets.size(); i++) {
+        char c = glyph_assets[i]->name[0];
+        if (seen.find(c) != std::string::npos) continue;
+        seen += c;
+        glyphs.push_back(glyph_assets[i]);
+    }
+    std::sort(glyphs.begin(), glyphs.end(), [](const Asset* x, const Asset* y) {
+        return (unsigned char)x->name[0] < (unsigned char)y->name[0];
+    });
+
+    std::string out;
+    out += "// Auto-generated by svgc - asset geometry tables\n";
+    out += "// DO NOT EDIT MANUALLY - include elxnk/asset_metadata.h instead\n\n";
+    out += "#ifndef ELXNK_ASSET_METADATA_TABLE_H\n";
+    out += "#define ELXNK_ASSET_METADATA_TABLE_H\n\n";
+    out += "namespace elxnk {\n\n";
+
+    for (size_t i = 0; i < components.size(); i++) {
+        const AssetInfo& info = components[i]->info;
+        if (info.pins.empty()) continue;
+        out += "constexpr AssetPoint " + symbol_name(components[i]->name) + "_pins[] = {";
+        for (size_t k = 0; k < info.pins.size(); k++) {
+            out += format("%s{%d, %d}", k ? ", " : "", info.pins[k].x, info.pins[k].y);
+        }
+        out += "};\n";
+    }
+
+    out += "\n// name, bounds, strokes, circles, pins marked, pin count, pins\n";
+    out += "constexpr ComponentInfo COMPONENT_INFO[] = {\n";
+    for (size_t i = 0; i < components.size(); i++) {
+        const Asset& a = *components[i];
+        out += format("    {\"%s\", %s, %d, %d, %s, %zu, %s},\n", a.name.c_str(),
+                      bounds_literal(a.info.bbox).c_str(), a.info.strokes, a.info.circles,
+                      a.info.pins_marked ? "true" : "false", a.info.pins.size(),
+                      a.info.pins.empty() ? "nullptr" : (symbol_name(a.name) + "_pins").c_str());
+    }
+    out += "};\n";
+    out += format("constexpr int COMPONENT_INFO_COUNT = %zu;\n\n", components.size());
+
+    out += "// character, bounds, strokes, circles, advance\n";
+    out += "constexpr GlyphInfo GLYPH_INFO[] = {\n";
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        const AssetInfo& info = glyphs[i]->info;
+        out += format("    {'%c', %s, %d, %d, %d},\n", glyphs[i]->name[0],
+                      bounds_literal(info.bbox).c_str(), info.strokes, info.circles,
+                      info.bbox.x1 + info.bbox.x0);
+    }
+    out += "};\n";
+    out += format("constexpr int GLYPH_INFO_COUNT = %zu;\n\n", glyphs.size());
+
+    out += "}  // namespace elxnk\n\n";
+    out += "#endif  // ELXNK_ASSET_METADATA_TABLE_H\n";
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Binary library output (little endian)
+
+static void put16(std::string& out, int v) {
+    out += (char)(v & 0xff);
+    out += (char)((v >> 8) & 0xff);
+}
+
+static void put32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out += (char)((v >> (8 * i)) & 0xff);
+}
+
+static void putf(std::string& out, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    put32(out, bits);
+}
+
+struct IndexEntry {
+    int kind;
+    std::string name;
+    const Asset* asset;
+
+    bool operator<(const IndexEntry& o) const {
+        if (kind != o.kind) return kind < o.kind;
+        return name < o.name;
+    }
+};
+
+static bool write_binary(const char* path, const std::vector<const Asset*>& components,
+                         const std::vector<const Asset*>& glyphs) {
+    std::vector<IndexEntry> index;
+    for (size_t i = 0; i < components.size(); i++) {
+        IndexEntry e = { LIBRARY_COMPONENT, components[i]->name.substr(0, LIBRARY_NAME_LEN - 1), components[i] };
+        index.push_back(e);
+    }
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        IndexEntry e = { LIBRARY_GLYPH, glyphs[i]->name.substr(0, 1), glyphs[i] };
+        index.push_back(e);
+    }
+    std::sort(index.begin(), index.end());
+
+    // Packed strokes, identical variants share one range across the file
+    std::vector<uint8_t> data;
+    std::map<CmdList, std::pair<uint32_t, uint32_t> > ranges;
+    std::string entries;
+
+    for (size_t i = 0; i < index.size(); i++) {
+        const Asset& a = *index[i].asset;
+        std::string name = index[i].name;
+        name.resize(LIBRARY_NAME_LEN, '\0');
+        entries += name;
+        entries += (char)index[i].kind;
+        entries.append(3, '\0');
+        for (int lod = 0; lod < LOD_LEVELS; lod++) putf(entries, (float)a.levels[lod].error);
+
+        for (int lod = 0; lod < LOD_LEVELS; lod++) {
+            for (int o = 0; o < ORIENTATIONS; o++) {
+                const CmdList& v = a.variant(lod, o);
+                std::map<CmdList, std::pair<uint32_t, uint32_t> >::iterator it = ranges.find(v);
+                if (it == ranges.end()) {
+                    uint32_t offset = (uint32_t)data.size();
+                    encode_commands(v, data);
+                    it = ranges.insert(std::make_pair(v, std::make_pair(offset, (uint32_t)v.size()))).first;
+                }
+                put32(entries, it->second.first);
+                put32(entries, it->second.second);
+            }
+        }
+    }
+
+    std::string out;
+    out += LIBRARY_MAGIC;
+    put16(out, LIBRARY_VERSION);
+    put16(out, LOD_LEVELS);
+    put16(out, ORIENTATIONS);
+    put16(out, LIBRARY_ENTRY_SIZE);
+    put32(out, index.size());
+    put32(out, LIBRARY_HEADER_SIZE);
+    put32(out, LIBRARY_HEADER_SIZE + entries.size());
+    put32(out, data.size());
+    put32(out, 0);
+    out += entries;
+    out.append(data.begin(), data.end());
+
+    FILE* f = fopen(path, "wb");
+    if (!f || fwrite(out.data(), 1, out.size(), f) != out.size() || fclose(f) != 0) {
+        perror(path);
+        return false;
+    }
+
+    printf("  Binary library: %s (%zu assets, %zu bytes of strokes, %zu bytes)\n",
+           path, index.size(), data.size(), out.size());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Optimization report: full-detail cost before and after stroke_optimizer.h
+
+static void print_report_header() {
+    printf("  %-8s %15s %21s %17s %13s %17s\n", "Asset", "Commands", "Events", "Draw (ms)", "Pen lifts",
+           "Travel (px)");
+}
+
+static void print_report_line(const char* name, const DrawStats& before, const DrawStats& after) {
+    printf("  %-8s %6d -> %-6d %9ld -> %-9ld %6.1f -> %-6.1f %4d -> %-4d %7.0f -> %-7.0f\n", name,
+           before.commands, after.commands, before.events, after.events,
+           before.time_us / 1000.0, after.time_us / 1000.0,
+           before.strokes, after.strokes, before.travel, after.travel);
+}
+
+static void add_stats(DrawStats& total, const DrawStats& s) {
+    total.commands += s.commands;
+    total.strokes += s.strokes;
+    total.events += s.events;
+    total.time_us += s.time_us;
+    total.travel += s.travel;
+}
+
+// ---------------------------------------------------------------------------
+// Draw cost limits: a budget per asset and a committed baseline, both on the
+// full-detail cost (the level drawn at scale 1.0 and above)
+
+struct CostLimits {
+    long budget_us;                             // 0: no budget
+    double tolerance;                           // Allowed growth over the baseline (%)
+    std::map<std::string, DrawStats> baseline;  // "component R" -> cost
+    bool have_baseline;
+
+    CostLimits() : budget_us(0), tolerance(0), have_baseline(false) {}
+};
+
+static std::string cost_key(const Asset& a) {
+    return (a.glyph ? "glyph " : "component ") + a.name;
+}
+
+// Baseline lines: <component|glyph> <name> <events> <time_us>
+static bool load_baseline(const char* path, CostLimits& limits) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Error: cannot read cost baseline %s\n", path);
+        return false;
+    }
+    char line[256], kind[16], name[64];
+    long events, time_us;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%15s %63s %ld %ld", kind, name, &events, &time_us) != 4) continue;
+        DrawStats& s = limits.baseline[std::string(kind) + " " + name];
+        s.events = events;
+        s.time_us = time_us;
+    }
+    fclose(f);
+    limits.have_baseline = true;
+    return true;
+}
+
+static std::string baseline_source(const std::vector<const Asset*>& assets) {
+    std::string out;
+    out += "# Draw cost baseline: full-detail evdev events and simulated draw time\n";
+    out += "# per asset (tools/svgc/draw_cost.h). The build fails when an asset\n";
+    out += "# gets more expensive than this; after an intended change, regenerate\n";
+    out += "# with: make -C src cost-baseline\n";
+    out += "# kind name events time_us\n";
+    for (size_t i = 0; i < assets.size(); i++) {
+        const DrawStats& c = assets[i]->levels[0].cost;
+        out += format("%s %ld %ld\n", cost_key(*assets[i]).c_str(), c.events, c.time_us);
+    }
+    return out;
+}
+
+// Check one asset against the budget and its baseline, reporting every failure
+static bool check_cost(const Asset& a, const CostLimits& limits) {
+    const DrawStats& c = a.levels[0].cost;
+    bool ok = true;
+
+    if (limits.budget_us > 0 && c.time_us > limits.budget_us) {
+        fprintf(stderr, "Error: %s draws in %.1f ms (%ld events), over the %.1f ms budget\n",
+                cost_key(a).c_str(), c.time_us / 1000.0, c.events, limits.budget_us / 1000.0);
+        ok = false;
+    }
+
+    std::map<std::string, DrawStats>::const_iterator it = limits.baseline.find(cost_key(a));
+    if (it != limits.baseline.end()) {
+        const DrawStats& base = it->second;
+        double scale = 1.0 + limits.tolerance / 100.0;
+        if (c.time_us > base.time_us * scale || c.events > base.events * scale) {
+            fprintf(stderr, "Error: %s draws in %.1f ms (%ld events), baseline %.1f ms (%ld events)\n",
+                    cost_key(a).c_str(), c.time_us / 1000.0, c.events, base.time_us / 1000.0, base.events);
+            fprintf(stderr, "       If intended, update the baseline: make -C src cost-baseline\n");
+            ok = false;
+        }
+    } else if (limits.have_baseline) {
+        fprintf(stderr, "Note: %s is not in the cost baseline\n", cost_key(a).c_str());
+    }
+    return ok;
+}
+
+// Parse a cost option at argv[i]; returns the arguments consumed, 0 if argv[i]
+// is not a cost option and -1 on error
+static int parse_cost_option(int argc, char** argv, int i, CostLimits& limits) {
+    if (i + 1 >= argc) return 0;
+    if (strcmp(argv[i], "--budget-ms") == 0) {
+        limits.budget_us = (long)(atof(argv[i + 1]) * 1000.0);
+        return 2;
+    }
+    if (strcmp(argv[i], "--tolerance") == 0) {
+        limits.tolerance = atof(argv[i + 1]);
+        return 2;
+    }
+    if (strcmp(argv[i], "--baseline") == 0) {
+        return load_baseline(argv[i + 1], limits) ? 2 : -1;
+    }
+    return 0;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s --component <file.svg> <out.cpp>     - One component source\n", prog);
+    fprintf(stderr, "       %s --glyph <file.svg> <out.cpp>         - One font glyph source\n", prog);
+    fprintf(stderr, "       %s --registry <out.cpp> <components_dir> <fonts_dir>\n", prog);
+    fprintf(stderr, "       %s <components_dir> <fonts_dir> --binary <library.elxl> [-j N]\n", prog);
+    fprintf(stderr, "       %s <components_dir> <fonts_dir> --metadata <out.h> [-j N]\n", prog);
+    fprintf(stderr, "       %s <components_dir> <fonts_dir> --write-baseline <costs.txt>\n", prog);
+    fprintf(stderr, "       %s --dump <file.svg>                    - Print lamp commands\n", prog);
+    fprintf(stderr, "Cost limits (asset and batch modes):\n");
+    fprintf(stderr, "  --budget-ms <ms>     Fail if an asset takes longer to draw at full detail\n");
+    fprintf(stderr, "  --baseline <file>    Fail if an asset costs more than in this baseline\n");
+    fprintf(stderr, "  --tolerance <pct>    Allowed growth over the baseline (default 0)\n");
+    fprintf(stderr, "Site library: %s site/components none --binary 50-site.elxl\n", prog);
+}
+
+// Convert one SVG (name = file stem)
+static bool convert_one(const char* path, bool glyph, Job& job) {
+    std::string stem = path;
+    size_t slash = stem.rfind('/');
+    if (slash != std::string::npos) stem = stem.substr(slash + 1);
+    if (stem.size() > 4 && stem.compare(stem.size() - 4, 4, ".svg") == 0) stem.resize(stem.size() - 4);
+
+    job.path = path;
+    job.asset.name = stem;
+    job.asset.glyph = glyph;
+    convert(job);
+    if (!job.asset.error.empty()) {
+        fprintf(stderr, "Error converting %s: %s\n", path, job.asset.error.c_str());
+        return false;
+    }
+    if (job.asset.cmds.empty()) {
+        fprintf(stderr, "Error: %s has nothing to draw\n", path);
+        return false;
+    }
+    return true;
+}
+
+static int dump(const char* path) {
+    Job job;
+    if (!convert_one(path, false, job)) return 1;
+    for (size_t i = 0; i < job.asset.cmds.size(); i++) {
+        printf("%s\n", job.asset.cmds[i].text().c_str());
+    }
+    return 0;
+}
+
+static int compile_asset(const char* path, bool glyph, const char* out, const CostLimits& limits) {
+    Job job;
+    if (!convert_one(path, glyph, job)) return 1;
+    print_report_line(job.asset.name.c_str(), job.asset.converted, job.asset.optimized);
+    if (!check_cost(job.asset, limits)) return 1;
+    return write_if_changed(out, asset_source(job.asset, path)) ? 0 : 1;
+}
+
+static int compile_registry(const char* out, const char* components_dir, const char* fonts_dir) {
+    std::string src = registry_source(list_stems(components_dir, true), list_stems(fonts_dir, false));
+    return write_if_changed(out, src) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) return dump(argv[2]);
+    if (argc == 5 && strcmp(argv[1], "--registry") == 0) return compile_registry(argv[2], argv[3], argv[4]);
+
+    CostLimits limits;
+    if (argc >= 4 && (strcmp(argv[1], "--component") == 0 || strcmp(argv[1], "--glyph") == 0)) {
+        for (int i = 4; i < argc;) {
+            int used = parse_cost_option(argc, argv, i, limits);
+            if (used < 0) return 1;
+            if (used == 0) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            i += used;
+        }
+        return compile_asset(argv[2], strcmp(argv[1], "--glyph") == 0, argv[3], limits);
+    }
+
+    std::vector<const char*> args;
+    const char* binary_file = NULL;
+    const char* metadata_file = NULL;
+    const char* baseline_file = NULL;
+    int threads = (int)std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++) {
+        int used = parse_cost_option(argc, argv, i, limits);
+        if (used < 0) return 1;
+        if (used > 0) {
+            i += used - 1;
+        } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            baseline_file = argv[++i];
+        } else if (strcmp(argv[i], "--binary") == 0 && i + 1 < argc) {
+            binary_file = argv[++i];
+        } else if (strcmp(argv[i], "--metadata") == 0 && i + 1 < argc) {
+            metadata_file = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (args.size() != 2 || (!binary_file && !metadata_file && !baseline_file)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* components_dir = args[0];
+    const char* fonts_dir = args[1];
+    double start = now_ms();
+
+    // Collect jobs: components first, then fonts, each in name order
+    std::vector<Job> jobs;
+    std::vector<std::string> stems = list_stems(components_dir, true);
+    for (size_t i = 0; i < stems.size(); i++) {
+        Job job;
+        job.path = std::string(components_dir) + "/" + stems[i] + ".svg";
+        job.asset.name = stems[i];
+        job.asset.glyph = false;
+        jobs.push_back(job);
+    }
+    stems = list_stems(fonts_dir, false);
+    for (size_t i = 0; i < stems.size(); i++) {
+        Job job;
+        job.path = std::string(fonts_dir) + "/" + stems[i] + ".svg";
+        job.asset.name = stems[i];
+        job.asset.glyph = true;
+        jobs.push_back(job);
+    }
+
+    run_jobs(jobs, threads);
+
+    std::vector<const Asset*> components, glyphs;
+    size_t total_commands = 0;
+    int failed = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const Asset& a = jobs[i].asset;
+        if (!a.error.empty()) {
+            fprintf(stderr, "Error converting %s: %s\n", jobs[i].path.c_str(), a.error.c_str());
+            failed++;
+            continue;
+        }
+        if (a.cmds.empty()) {
+            fprintf(stderr, "Warning: %s has nothing to draw, skipped\n", jobs[i].path.c_str());
+            continue;
+        }
+        (a.glyph ? glyphs : components).push_back(&a);
+        total_commands += a.cmds.size();
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const Asset& a = jobs[i].asset;
+        if (a.error.empty() && !a.cmds.empty() && !check_cost(a, limits)) failed++;
+    }
+    if (failed) return 1;
+
+    if (baseline_file) {
+        std::vector<const Asset*> assets(components);
+        assets.insert(assets.end(), glyphs.begin(), glyphs.end());
+        if (!write_if_changed(baseline_file, baseline_source(assets))) return 1;
+        printf("Cost baseline: %s (%zu assets)\n", baseline_file, assets.size());
+    }
+    if (metadata_file && !write_if_changed(metadata_file, metadata_source(components, glyphs))) return 1;
+    if (!binary_file) return 0;
+
+    DrawStats before, after;
+    print_report_header();
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const Asset& a = jobs[i].asset;
+        if (a.cmds.empty()) continue;
+        print_report_line(a.name.c_str(), a.converted, a.optimized);
+        add_stats(before, a.converted);
+        add_stats(after, a.optimized);
+    }
+    print_report_line("Total", before, after);
+
+    printf("Library: %zu components, %zu font glyphs, %zu commands\n",
+           components.size(), glyphs.size(), total_commands);
+
+    // Embedded library size: every asset packed on its own, as make library builds it
+    size_t packed_bytes = 0, text_bytes = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (!jobs[i].asset.error.empty() || jobs[i].asset.cmds.empty()) continue;
+        PackedAsset packed;
+        pack_asset(jobs[i].asset, packed);
+        packed_bytes += packed.data.size();
+        text_bytes += packed.text_bytes;
+    }
+    printf("  Embedded strokes: %zu bytes packed, %zu bytes as strings (%.0f%%)\n",
+           packed_bytes, text_bytes, text_bytes ? 100.0 * packed_bytes / text_bytes : 0.0);
+    if (!write_binary(binary_file, components, glyphs)) return 1;
+
+    printf("  Time: %.1f ms (%d threads)\n", now_ms() - start, threads);
+    return 0;
+}
@@ -1,5 +1,5 @@
 #!/bin/bash
-# Test svg_to_lamp_final.py on all SVG files
+# Test svgc on all SVG files
 # Shows detailed statistics and identifies problematic files
 
 set -e
@@ -7,7 +7,7 @@ set -e
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROJECT_ROOT="$SCRIPT_DIR/.."
 
-CONVERTER="$PROJECT_ROOT/tools/svg_to_lamp_final.py"
+SVGC="$PROJECT_ROOT/build/host/svgc"
 COMPONENTS_DIR="$PROJECT_ROOT/assets/components"
 FONTS_DIR="$PROJECT_ROOT/assets/font"
 
@@ -21,15 +21,9 @@ echo "SVG to LAMP Converter Test Suite"
 echo "============================================"
 echo ""
 
-# Check dependencies
-if ! python3 -c "import svgpathtools" 2>/dev/null; then
-    echo -e "${RED}ERROR: svgpathtools not installed${NC}"
-    echo "Install: pip install svgpathtools"
-    exit 1
-fi
-
-if [ ! -f "$CONVERTER" ]; then
-    echo -e "${RED}ERROR: Converter not found: $CONVERTER${NC}"
+# Build the compiler (host tool)
+if ! make -s -C "$PROJECT_ROOT/src" svgc >/dev/null; then
+    echo -e "${RED}ERROR: Could not build svgc${NC}"
     exit 1
 fi
 
@@ -39,7 +33,7 @@ test_svg() {
     local name=$(basename "$svg_file" .svg)
     
     # Run converter and capture output
-    if output=$(python3 "$CONVERTER" "$svg_file" 2>&1); then
+    if output=$("$SVGC" --dump "$svg_file" 2>&1); then
         # Count commands
         cmd_count=$(echo "$output" | grep -c "^pen " || true)
         
@@ -128,7 +122,7 @@ if [ "$fail" -eq 0 ]; then
     echo ""
     echo -e "${GREEN}✓ ALL TESTS PASSED${NC}"
     echo ""
-    echo "Ready to generate header:"
+    echo "Ready to regenerate the library:"
     echo "  ./rebuild_library.sh"
     exit 0
 else